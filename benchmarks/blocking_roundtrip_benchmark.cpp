@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstdio>
+#include <future>
+
+#include "core/queued_task.h"
+#include "core/task_queue.h"
+#include "signal.hpp"
+#include "stats.h"
+
+// Round trip latency of a blocking_queued_connection emission, from an
+// emitting thread to a TaskQueueStdlib worker and back. The reference is
+// what blocking emissions used to do: post a closure signaling a
+// std::promise, which allocates its shared state, and wait on its future.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int warmup = 1000;
+constexpr int samples = 50000;
+
+long total = 0;
+
+void signal_roundtrip(core::TaskQueue& queue) {
+    sigslot::signal<int> sig;
+    sig.connect([](int v) { total += v; }, sigslot::blocking_queued_connection, &queue);
+
+    latency_stats stats;
+    for (int i = 0; i < warmup + samples; ++i) {
+        const auto start = clock_type::now();
+        sig(1);
+        if (i >= warmup) {
+            stats.add(clock_type::now() - start);
+        }
+    }
+    stats.print("blocking_queued_connection");
+}
+
+void promise_roundtrip(core::TaskQueue& queue) {
+    latency_stats stats;
+    for (int i = 0; i < warmup + samples; ++i) {
+        const auto start = clock_type::now();
+        std::promise<void> done;
+        queue.PostTask(core::ToQueuedTask([&] {
+            total += 1;
+            done.set_value();
+        }));
+        done.get_future().get();
+        if (i >= warmup) {
+            stats.add(clock_type::now() - start);
+        }
+    }
+    stats.print("closure + std::promise");
+}
+
+} // namespace
+
+int main() {
+    auto queue = core::TaskQueue::Create("worker");
+    signal_roundtrip(*queue);
+    promise_roundtrip(*queue);
+    return 0;
+}
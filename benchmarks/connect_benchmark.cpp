@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "signal.hpp"
+
+// Connecting 100k slots to one signal, with and without unique_connection,
+// one by one and in a single batch(). Unique connections look the callable
+// up in a hash index, so they cost the same as the others. Each connect
+// outside a batch still publishes a new slot table, copying its chunk
+// pointers, which a batch does once.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int kSlots = 100000;
+
+constexpr uint32_t kUnique = sigslot::unique_connection | sigslot::direct_connection;
+
+struct receiver {
+    void on_value(int v) { n += v; }
+    int n = 0;
+};
+
+double ms_since(clock_type::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+void connect_all(const char *label, uint32_t type) {
+    sigslot::signal<int> sig;
+    std::vector<receiver> receivers(kSlots);
+    const auto start = clock_type::now();
+    for (auto &r : receivers) {
+        sig.connect(&r, &receiver::on_value, type);
+    }
+    std::printf("%-34s %8.1f ms\n", label, ms_since(start));
+}
+
+void reject_duplicates() {
+    sigslot::signal<int> sig;
+    std::vector<receiver> receivers(kSlots);
+    for (auto &r : receivers) {
+        sig.connect(&r, &receiver::on_value, kUnique);
+    }
+    constexpr int attempts = 10000;
+    int rejected = 0;
+    const auto start = clock_type::now();
+    for (int i = 0; i < attempts; ++i) {
+        rejected += !sig.connect(&receivers[std::size_t(i) * 7 % kSlots], &receiver::on_value, kUnique).valid();
+    }
+    std::printf("%-34s %8.3f us each (%d of %d rejected)\n", "duplicate unique connect",
+                ms_since(start) * 1000 / attempts, rejected, attempts);
+}
+
+// a single copy of the slot table, published once
+void connect_in_batch() {
+    sigslot::signal<int> sig;
+    std::vector<receiver> receivers(kSlots);
+    const auto start = clock_type::now();
+    sig.batch([&](auto& tx) {
+        for (auto &r : receivers) {
+            tx.connect(&r, &receiver::on_value, kUnique);
+        }
+    });
+    std::printf("%-34s %8.1f ms\n", "unique, in one batch()", ms_since(start));
+}
+
+} // namespace
+
+int main() {
+    std::printf("connecting %d slots\n", kSlots);
+    connect_all("plain", sigslot::direct_connection);
+    connect_all("unique", kUnique);
+    connect_in_batch();
+    reject_duplicates();
+    return 0;
+}
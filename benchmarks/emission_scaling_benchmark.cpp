@@ -0,0 +1,60 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "signal.hpp"
+
+// Emission throughput of one signal shared by 1 to 16 emitting threads.
+// Emission takes no lock and writes no shared memory, so the throughput
+// should grow linearly with the threads up to the number of cores, and
+// stay flat past it.
+
+namespace {
+
+// per thread, so that slots do not contend either
+thread_local long calls = 0;
+
+void run(int threads, int slots) {
+    sigslot::signal<int> sig;
+    for (int i = 0; i < slots; ++i) {
+        sig.connect([](int v) { calls += v; });
+    }
+
+    const long per_thread = 4000000 / threads / slots;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> emitters;
+    for (int t = 0; t < threads; ++t) {
+        emitters.emplace_back([&] {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (long i = 0; i < per_thread; ++i) {
+                sig(1);
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto &t : emitters) {
+        t.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double emissions = double(per_thread) * threads;
+    std::printf("%2d threads %3d slots: %8.1f ns per emission, %6.2f M emissions/s\n",
+                threads, slots, elapsed.count() * 1e9 / emissions, emissions / elapsed.count() / 1e6);
+}
+
+} // namespace
+
+int main() {
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    for (int slots : {1, 8}) {
+        for (int threads : {1, 2, 4, 8, 16}) {
+            run(threads, slots);
+        }
+    }
+    return 0;
+}
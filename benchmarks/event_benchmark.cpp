@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "core/event.h"
+#include "stats.h"
+
+// core::Event costs. Built twice on Linux: event_benchmark runs the futex
+// implementation, event_benchmark_condvar the pthread mutex and condition
+// variable one that other POSIX systems use.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double ns_per(clock_type::time_point start, int n) {
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / n;
+}
+
+} // namespace
+
+int main() {
+#if defined(CORE_LINUX)
+    std::printf("futex event\n");
+#else
+    std::printf("condition variable event\n");
+#endif
+
+    {
+        core::Event e;
+        constexpr int n = 2000000;
+        const auto start = clock_type::now();
+        for (int i = 0; i < n; ++i) {
+            e.Set();
+        }
+        std::printf("Set() with no waiter:      %8.1f ns\n", ns_per(start, n));
+    }
+    {
+        core::Event e;
+        constexpr int n = 2000000;
+        const auto start = clock_type::now();
+        for (int i = 0; i < n; ++i) {
+            e.Set();
+            e.Wait(core::Event::kForever);
+        }
+        std::printf("Set()+Wait(), same thread: %8.1f ns\n", ns_per(start, n));
+    }
+    {
+        // each side waits for the other, a round trip is two wake-ups
+        core::Event ping;
+        core::Event pong;
+        constexpr int n = 100000;
+        std::thread peer([&] {
+            for (int i = 0; i < n; ++i) {
+                ping.Wait(core::Event::kForever);
+                pong.Set();
+            }
+        });
+        latency_stats stats;
+        for (int i = 0; i < n; ++i) {
+            const auto start = clock_type::now();
+            ping.Set();
+            pong.Wait(core::Event::kForever);
+            stats.add(clock_type::now() - start);
+        }
+        peer.join();
+        stats.print("ping-pong round trip");
+    }
+    {
+        core::Event e;
+        latency_stats stats;
+        for (int i = 0; i < 50; ++i) {
+            const auto start = clock_type::now();
+            e.Wait(core::TimeDelta::Millis(2));
+            stats.add(clock_type::now() - start - std::chrono::milliseconds(2));
+        }
+        stats.print("Wait(2 ms) timeout lateness");
+    }
+    return 0;
+}
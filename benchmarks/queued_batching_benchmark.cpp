@@ -0,0 +1,82 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "core/queued_task.h"
+#include "core/task_queue.h"
+#include "signal.hpp"
+
+// Queued emission of a signal with 64 slots spread over 2 queues. The
+// signal posts one task per queue and emission, the reference posts one
+// task per slot, as queued emission did before batching.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int kSlots = 64;
+constexpr long kEmissions = 100000;
+
+std::atomic<long> calls{0};
+
+void on_value(int v) {
+    calls.fetch_add(v, std::memory_order_relaxed);
+}
+
+struct per_slot_call final : core::QueuedTask {
+    explicit per_slot_call(int v) : value(v) {}
+
+    bool run() override {
+        on_value(value);
+        return true;
+    }
+
+    int value;
+};
+
+// waits for the slots to have run, every 64 emissions so that the queues
+// stay short
+template <typename Emit>
+double run(Emit&& emit) {
+    calls = 0;
+    const auto start = clock_type::now();
+    for (long i = 0; i < kEmissions; ++i) {
+        emit();
+        if (i % 64 == 63) {
+            while (calls.load() < (i + 1) * kSlots) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    while (calls.load() < kEmissions * kSlots) {
+        std::this_thread::yield();
+    }
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / kEmissions;
+}
+
+} // namespace
+
+int main() {
+    auto first = core::TaskQueue::Create("first");
+    auto second = core::TaskQueue::Create("second");
+    core::TaskQueue *queues[] = {first.get(), second.get()};
+
+    sigslot::signal<int> sig;
+    for (int i = 0; i < kSlots; ++i) {
+        sig.connect(&on_value, sigslot::queued_connection, queues[i % 2]);
+    }
+    const double batched = run([&] { sig(1); });
+
+    const double per_slot = run([&] {
+        for (int i = 0; i < kSlots; ++i) {
+            queues[i % 2]->PostTask(std::make_unique<per_slot_call>(1));
+        }
+    });
+
+    std::printf("%d slots on 2 queues, per emission until all slots ran\n", kSlots);
+    std::printf("one task per queue: %8.1f ns\n", batched);
+    std::printf("one task per slot:  %8.1f ns\n", per_slot);
+    return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+// Latency samples of a benchmark, in microseconds.
+class latency_stats {
+public:
+    void add(double us) {
+        m_samples.push_back(us);
+    }
+
+    template <typename Duration>
+    void add(Duration d) {
+        add(std::chrono::duration<double, std::micro>(d).count());
+    }
+
+    // p in [0, 1], the samples get sorted
+    double percentile(double p) {
+        if (m_samples.empty()) {
+            return 0;
+        }
+        std::sort(m_samples.begin(), m_samples.end());
+        const auto i = static_cast<std::size_t>(p * double(m_samples.size() - 1) + 0.5);
+        return m_samples[i];
+    }
+
+    void print(const char *label) {
+        std::printf("%-28s p50 %8.2f us   p90 %8.2f us   p99 %8.2f us   max %8.2f us\n", label,
+                    percentile(0.5), percentile(0.9), percentile(0.99), percentile(1));
+    }
+
+private:
+    std::vector<double> m_samples;
+};
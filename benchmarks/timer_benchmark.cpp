@@ -0,0 +1,104 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/event.h"
+#include "core/queued_task.h"
+#include "core/task_queue.h"
+
+// Schedules 1M delayed tasks, 1 to 1000 ms away, on a TaskQueueStdlib and
+// reports the cost of PostDelayedTask and how long after the last deadline
+// the timer wheel has run them all. The same insertions into the std::map
+// the queue used before are timed for reference.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int kTimers = 1000000;
+
+struct increment final : core::QueuedTask {
+    explicit increment(std::atomic<long>& c) : count(c) {}
+
+    bool run() override {
+        count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::atomic<long>& count;
+};
+
+std::vector<int> random_delays() {
+    std::mt19937 rng(1);
+    std::vector<int> delays(kTimers);
+    for (auto &d : delays) {
+        d = 1 + static_cast<int>(rng() % 1000);
+    }
+    return delays;
+}
+
+void timer_wheel(const std::vector<int>& delays) {
+    auto queue = core::TaskQueue::Create("timers");
+    std::atomic<long> count{0};
+    std::vector<std::unique_ptr<core::QueuedTask>> tasks;
+    tasks.reserve(kTimers);
+    for (int i = 0; i < kTimers; ++i) {
+        tasks.push_back(std::make_unique<increment>(count));
+    }
+
+    // posted from the worker itself, so that it does not run timers while
+    // they are being inserted
+    core::Event posted;
+    double post_ns = 0;
+    clock_type::time_point start;
+    queue->PostTask(core::ToQueuedTask([&] {
+        start = clock_type::now();
+        for (int i = 0; i < kTimers; ++i) {
+            queue->PostDelayedTask(std::move(tasks[i]), core::TimeDelta::Millis(delays[i]));
+        }
+        post_ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / kTimers;
+        posted.Set();
+    }));
+    posted.Wait(core::Event::kForever);
+
+    while (count.load() < kTimers) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const std::chrono::duration<double, std::milli> elapsed = clock_type::now() - start;
+    std::printf("timer wheel: %6.1f ns per PostDelayedTask, all run %.0f ms after posting (last deadline 1000 ms)\n",
+                post_ns, elapsed.count());
+}
+
+void ordered_map(const std::vector<int>& delays) {
+    std::map<std::pair<int64_t, uint64_t>, std::unique_ptr<core::QueuedTask>> timers;
+    std::atomic<long> count{0};
+    std::vector<std::unique_ptr<core::QueuedTask>> tasks;
+    tasks.reserve(kTimers);
+    for (int i = 0; i < kTimers; ++i) {
+        tasks.push_back(std::make_unique<increment>(count));
+    }
+
+    const auto start = clock_type::now();
+    const int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(start.time_since_epoch()).count();
+    for (int i = 0; i < kTimers; ++i) {
+        timers.emplace(std::make_pair(now_us + delays[i] * int64_t(1000), uint64_t(i)), std::move(tasks[i]));
+    }
+    const double insert_ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / kTimers;
+    std::printf("std::map:    %6.1f ns per insertion\n", insert_ns);
+}
+
+} // namespace
+
+int main() {
+    const auto delays = random_delays();
+    timer_wheel(delays);
+    ordered_map(delays);
+    return 0;
+}
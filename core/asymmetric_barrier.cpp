@@ -0,0 +1,53 @@
+#include "asymmetric_barrier.h"
+
+#if defined(CORE_WIN)
+#include <windows.h>
+#elif defined(CORE_LINUX)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+
+#if defined(CORE_LINUX)
+    namespace {
+
+        // Expedited barriers interrupt the running threads of the process
+        // rather than waiting for a scheduler grace period. Unavailable before
+        // Linux 4.14, or when filtered out by a sandbox.
+        bool RegisterMembarrier() {
+            const long cmds = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+            if (cmds < 0 || !(cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED)) {
+                return false;
+            }
+            return syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+        }
+
+    }  // namespace
+#endif
+
+    bool AsymmetricBarrierIsProcessWide() {
+#if defined(CORE_WIN)
+        return true;
+#elif defined(CORE_LINUX)
+        static const bool registered = RegisterMembarrier();
+        return registered;
+#else
+        return false;
+#endif
+    }
+
+    void AsymmetricHeavyBarrier() {
+        if (!AsymmetricBarrierIsProcessWide()) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return;
+        }
+#if defined(CORE_WIN)
+        ::FlushProcessWriteBuffers();
+#elif defined(CORE_LINUX)
+        syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+#endif
+    }
+
+}  // namespace core
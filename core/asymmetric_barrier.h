@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+
+namespace core {
+
+    // An asymmetric memory barrier, for synchronization where one side runs
+    // far more often than the other. The frequent side calls
+    // AsymmetricLightBarrier(), which is a compiler barrier only where the
+    // platform lets AsymmetricHeavyBarrier() execute a full barrier on every
+    // running thread of the process, and a full barrier otherwise. A light and
+    // a heavy barrier order memory like two full barriers would.
+    //
+    // Process wide barriers are membarrier(2) on Linux and
+    // FlushProcessWriteBuffers() on Windows.
+
+    // Whether the heavy barrier is process wide, decided once.
+    bool AsymmetricBarrierIsProcessWide();
+
+    inline void AsymmetricLightBarrier() {
+        static const bool process_wide = AsymmetricBarrierIsProcessWide();
+        if (process_wide) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        } else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void AsymmetricHeavyBarrier();
+
+}  // namespace core
@@ -15,6 +15,9 @@
 
 #if defined(CORE_WIN)
 #include <windows.h>
+#elif defined(CORE_LINUX)
+#include <stdint.h>
+#include <atomic>
 #elif defined(CORE_POSIX)
 #include <pthread.h>
 #else
@@ -90,6 +93,12 @@ namespace core {
     private:
 #if defined(CORE_WIN)
         HANDLE event_handle_;
+#elif defined(CORE_LINUX)
+        // Bit 0 is the signaled flag, the remaining bits count the threads
+        // sleeping on the futex, so that Set() only makes a syscall when there
+        // is someone to wake and never touches the event after the wake-up.
+        std::atomic<uint32_t> state_;
+        const bool is_manual_reset_;
 #elif defined(CORE_POSIX)
         pthread_mutex_t event_mutex_;
         pthread_cond_t event_cond_;
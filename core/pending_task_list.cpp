@@ -0,0 +1,71 @@
+#include "pending_task_list.h"
+#include <utility>
+
+namespace core {
+
+    IncomingTaskStack::~IncomingTaskStack() {
+        QueuedTask* t = take_all();
+        while (t) {
+            delete std::exchange(t, t->next_);
+        }
+    }
+
+    bool IncomingTaskStack::empty() const {
+        return head_.load() == nullptr;
+    }
+
+    void IncomingTaskStack::push(std::unique_ptr<QueuedTask> task, uint64_t order) {
+        QueuedTask* t = task.release();
+        t->order_ = order;
+        t->next_ = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(t->next_, t,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    QueuedTask* IncomingTaskStack::take_all() {
+        // The stack holds the most recent task first, reverse it.
+        QueuedTask* t = head_.exchange(nullptr, std::memory_order_acquire);
+        QueuedTask* first = nullptr;
+        while (t) {
+            QueuedTask* next = t->next_;
+            t->next_ = first;
+            first = t;
+            t = next;
+        }
+        return first;
+    }
+
+    PendingTaskList::~PendingTaskList() {
+        while (!empty()) {
+            pop();
+        }
+    }
+
+    void PendingTaskList::append(QueuedTask* first) {
+        if (!first) {
+            return;
+        }
+        if (tail_) {
+            tail_->next_ = first;
+        } else {
+            head_ = first;
+        }
+        tail_ = first;
+        while (tail_->next_) {
+            tail_ = tail_->next_;
+        }
+    }
+
+    std::unique_ptr<QueuedTask> PendingTaskList::pop() {
+        QueuedTask* t = head_;
+        head_ = t->next_;
+        if (!head_) {
+            tail_ = nullptr;
+        }
+        t->next_ = nullptr;
+        return std::unique_ptr<QueuedTask>(t);
+    }
+
+}
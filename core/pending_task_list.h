@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include "queued_task.h"
+
+namespace core {
+
+    // Lock-free stack of freshly posted tasks, linked through their QueuedTask
+    // hook. Any thread may push, only the consuming thread takes the tasks out,
+    // all of them at once. Owns the tasks it holds.
+    class IncomingTaskStack {
+    public:
+        IncomingTaskStack() = default;
+        IncomingTaskStack(const IncomingTaskStack&) = delete;
+        IncomingTaskStack& operator=(const IncomingTaskStack&) = delete;
+        ~IncomingTaskStack();
+
+        bool empty() const;
+
+        // Sequentially consistent, so that it is ordered against whatever the
+        // poster checks next to decide whether the consumer needs a wake-up.
+        void push(std::unique_ptr<QueuedTask> task, uint64_t order);
+
+        // Empties the stack and returns its tasks linked in posting order.
+        QueuedTask* take_all();
+
+    private:
+        std::atomic<QueuedTask*> head_{nullptr};
+    };
+
+    // Intrusive FIFO list of tasks, linked through their QueuedTask hook so
+    // that posting does not allocate. Not thread safe, owns the tasks it holds.
+    class PendingTaskList {
+    public:
+        PendingTaskList() = default;
+        PendingTaskList(const PendingTaskList&) = delete;
+        PendingTaskList& operator=(const PendingTaskList&) = delete;
+        ~PendingTaskList();
+
+        bool empty() const { return head_ == nullptr; }
+        QueuedTask* front() const { return head_; }
+        void append(QueuedTask* first);
+        std::unique_ptr<QueuedTask> pop();
+
+    private:
+        QueuedTask* head_ = nullptr;
+        QueuedTask* tail_ = nullptr;
+    };
+
+}
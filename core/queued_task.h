@@ -1,10 +1,16 @@
 #pragma once
 
+#include <stdint.h>
 #include <type_traits>
 #include <memory>
 
 namespace core {
 
+    class IncomingTaskStack;
+    class PendingTaskList;
+    class TaskQueueStdlib;
+    class TimerWheel;
+
     // Base interface for asynchronously executed tasks.
     // The interface basically consists of a single function, run(), that executes
     // on the target queue.  For more details see the run() method and TaskQueue.
@@ -18,6 +24,19 @@ namespace core {
         // having been transferred.  Returning |false| can be useful if a task has
         // re-posted itself to a different queue or is otherwise being re-used.
         virtual bool run() = 0;
+
+    private:
+        friend class IncomingTaskStack;
+        friend class PendingTaskList;
+        friend class TaskQueueStdlib;
+        friend class TimerWheel;
+
+        // Intrusive hook, lets a task queue link pending tasks together without
+        // allocating a container node for each of them. Only meaningful while the
+        // task is owned by a queue.
+        QueuedTask* next_ = nullptr;
+        uint64_t order_ = 0;
+        int64_t fire_at_us_ = 0;
     };
 
     // Simple implementation of QueuedTask for use with rtc::Bind and lambdas.
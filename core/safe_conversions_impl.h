@@ -13,6 +13,8 @@
 #ifndef RTC_BASE_NUMERICS_SAFE_CONVERSIONS_IMPL_H_
 #define RTC_BASE_NUMERICS_SAFE_CONVERSIONS_IMPL_H_
 
+#include <stddef.h>
+
 #include <limits>
 
 namespace core {
@@ -0,0 +1,154 @@
+#include "sequenced_task_queue.h"
+#include <assert.h>
+#include <utility>
+#include "task_queue_thread_pool.h"
+
+namespace core {
+
+    class SequencedTaskQueue::DrainTask final : public QueuedTask {
+    public:
+        explicit DrainTask(SequencedTaskQueue* queue)
+        : queue_(queue) {}
+
+        ~DrainTask() override {
+            if (queue_) {
+                queue_->DrainDropped();
+            }
+        }
+
+        // Cleared when the queue deletes the task itself.
+        SequencedTaskQueue* queue_;
+
+    private:
+        bool run() override {
+            queue_->Drain();
+            // Owned by the queue, scheduled again on the next post.
+            return false;
+        }
+    };
+
+    // Posts a delayed task to the queue once the timer of the pool fires,
+    // keeping the queue allocated meanwhile.
+    class SequencedTaskQueue::DelayedTask final : public QueuedTask {
+    public:
+        DelayedTask(std::unique_ptr<QueuedTask> task, SequencedTaskQueue* queue)
+        : task_(std::move(task))
+        , queue_(queue) {
+            queue_->AddRef();
+        }
+
+        ~DelayedTask() override {
+            queue_->Release();
+        }
+
+    private:
+        bool run() override {
+            if (!queue_->deleted_.load()) {
+                queue_->PostTask(std::move(task_));
+            }
+            return true;
+        }
+
+        std::unique_ptr<QueuedTask> task_;
+        SequencedTaskQueue* const queue_;
+    };
+
+    SequencedTaskQueue::SequencedTaskQueue(std::string_view queue_name, TaskQueueThreadPool* pool)
+    : pool_(pool)
+    , name_(queue_name)
+    , drain_(new DrainTask(this)) {}
+
+    SequencedTaskQueue::~SequencedTaskQueue() {
+        if (drain_) {
+            drain_->queue_ = nullptr;
+            delete drain_;
+        }
+    }
+
+    void SequencedTaskQueue::Delete() {
+        assert(!IsCurrent());
+        {
+            // Waits for the task being run, if any, none starts afterwards.
+            std::unique_lock<std::mutex> lock(run_lock_);
+            deleted_.store(true);
+        }
+        Release();
+    }
+
+    void SequencedTaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
+        incoming_.push(std::move(task), 0);
+        // The push is sequentially consistent, so either the drain task sees
+        // the new task when it looks again after clearing scheduled_, or this
+        // sees scheduled_ cleared and schedules it.
+        if (!scheduled_.load() && !scheduled_.exchange(true)) {
+            AddRef();
+            pool_->PostTask(std::unique_ptr<QueuedTask>(drain_));
+        }
+    }
+
+    void SequencedTaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) {
+        pool_->PostDelayedTask(std::make_unique<DelayedTask>(std::move(task), this), delay);
+    }
+
+    void SequencedTaskQueue::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) {
+        pool_->PostDelayedHighPrecisionTask(std::make_unique<DelayedTask>(std::move(task), this), delay);
+    }
+
+    const std::string& SequencedTaskQueue::Name() const {
+        return name_;
+    }
+
+    void SequencedTaskQueue::AddRef() {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void SequencedTaskQueue::Release() {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    void SequencedTaskQueue::Drain() {
+        {
+            CurrentTaskQueueSetter setCurrent(this);
+            for (int i = 0; i < kMaxTasksPerDrain; ++i) {
+                if (pending_.empty()) {
+                    pending_.append(incoming_.take_all());
+                    if (pending_.empty()) {
+                        break;
+                    }
+                }
+                std::unique_lock<std::mutex> lock(run_lock_);
+                if (deleted_.load()) {
+                    break;
+                }
+                QueuedTask* task = pending_.pop().release();
+                if (task->run()) {
+                    delete task;
+                }
+            }
+        }
+
+        const bool deleted = deleted_.load();
+        if (!deleted && (!pending_.empty() || !incoming_.empty())) {
+            // Still busy, let the work queued meanwhile run first.
+            pool_->PostTaskFair(std::unique_ptr<QueuedTask>(drain_));
+            return;
+        }
+
+        scheduled_.store(false);
+        // A post may have come in between the last look at incoming_ and the
+        // store above without scheduling, pick it up.
+        if (!deleted && !incoming_.empty() && !scheduled_.exchange(true)) {
+            pool_->PostTaskFair(std::unique_ptr<QueuedTask>(drain_));
+            return;
+        }
+        Release();
+    }
+
+    void SequencedTaskQueue::DrainDropped() {
+        drain_ = nullptr;
+        Release();
+    }
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "pending_task_list.h"
+#include "queued_task.h"
+#include "task_queue_base.h"
+
+namespace core {
+
+    class TaskQueueThreadPool;
+
+    // A sequenced task queue, or strand, running on a shared TaskQueueThreadPool.
+    //
+    // Tasks run in FIFO order and never overlap, like on a TaskQueueStdlib, and
+    // IsCurrent() is true while they run, but the queue has no thread of its
+    // own: whenever it has tasks pending, a single drain task is scheduled on
+    // the pool and runs them in batches. A queue is then only a few hundred bytes,
+    // so there can be one per session or per object rather than one per thread.
+    //
+    // The drain task gives its worker up after kMaxTasksPerDrain tasks and
+    // queues itself again behind the other work of the pool, so that a busy
+    // queue cannot starve the others. Delayed tasks are kept by the timer of the
+    // pool and posted to the queue when they are due.
+    //
+    // The pool must outlive its sequenced queues. Deallocation happens once the
+    // queue is deleted and no drain or delayed task refers to it anymore.
+    class SequencedTaskQueue final : public TaskQueueBase {
+    public:
+        static constexpr int kMaxTasksPerDrain = 32;
+
+        SequencedTaskQueue(std::string_view queue_name, TaskQueueThreadPool* pool);
+
+        void Delete() override;
+        void PostTask(std::unique_ptr<QueuedTask> task) override;
+        void PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) override;
+        void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) override;
+        const std::string& Name() const override;
+
+    private:
+        class DrainTask;
+        class DelayedTask;
+
+        ~SequencedTaskQueue() override;
+
+        void AddRef();
+        void Release();
+
+        // Runs a batch of tasks on a worker of the pool.
+        void Drain();
+
+        // The pool went away with the drain task still queued.
+        void DrainDropped();
+
+        TaskQueueThreadPool* const pool_;
+
+        std::string name_;
+
+        // One reference for the owner, until Delete(), one for the drain task
+        // while it is scheduled and one for each delayed task in flight.
+        std::atomic<int> refs_{1};
+
+        // Set while the drain task is queued on the pool or running. Posters only
+        // schedule it when they are the ones to set this.
+        std::atomic<bool> scheduled_{false};
+
+        std::atomic<bool> deleted_{false};
+
+        // Held while a task runs, so that Delete() can wait for it.
+        std::mutex run_lock_;
+
+        IncomingTaskStack incoming_;
+
+        // Tasks taken from incoming_, only touched by the drain task.
+        PendingTaskList pending_;
+
+        // Reused for every scheduling, owned by the pool while it is queued.
+        DrainTask* drain_;
+    };
+}
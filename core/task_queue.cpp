@@ -1,6 +1,9 @@
 #include "task_queue.h"
 #include "task_queue_base.h"
+#include "sequenced_task_queue.h"
 #include "task_queue_stdlib.h"
+#include "task_queue_thread_pool.h"
+#include <thread>
 
 namespace core {
 
@@ -23,12 +26,35 @@ namespace core {
         return impl_->PostTask(std::move(task));
     }
 
+    void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task, TaskPriority priority) {
+        return impl_->PostTaskWithPriority(std::move(task), priority);
+    }
+
     void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) {
         return impl_->PostDelayedTask(std::move(task), delay);
     }
 
+    void TaskQueue::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) {
+        return impl_->PostDelayedHighPrecisionTask(std::move(task), delay);
+    }
+
     std::unique_ptr<TaskQueue> TaskQueue::Create(std::string_view name) {
         return std::make_unique<TaskQueue>(std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(new TaskQueueStdlib(name)));
     }
 
+    std::unique_ptr<TaskQueue> TaskQueue::CreateThreadPool(std::string_view name, size_t threads) {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        return std::make_unique<TaskQueue>(std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(new TaskQueueThreadPool(name, threads)));
+    }
+
+    std::unique_ptr<TaskQueue> TaskQueue::CreateSequenced(std::string_view name, TaskQueue* pool) {
+        auto* threadPool = pool ? dynamic_cast<TaskQueueThreadPool*>(pool->Get()) : nullptr;
+        if (!threadPool) {
+            return nullptr;
+        }
+        return std::make_unique<TaskQueue>(std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(new SequencedTaskQueue(name, threadPool)));
+    }
+
 }
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <memory>
 #include <string_view>
 #include "queued_task.h"
+#include "task_queue_base.h"
 #include "time_delta.h"
 
 namespace core {
@@ -66,6 +68,17 @@ namespace core {
 
         static std::unique_ptr<TaskQueue> Create(std::string_view name);
 
+        // Creates a queue running its tasks on a work stealing pool of `threads`
+        // workers, 0 meaning one per hardware thread. Its tasks are not run in
+        // FIFO order and may run concurrently, see TaskQueueThreadPool.
+        static std::unique_ptr<TaskQueue> CreateThreadPool(std::string_view name, size_t threads = 0);
+
+        // Creates a sequenced queue running its tasks in FIFO order on the
+        // workers of `pool`, which must come from CreateThreadPool and outlive
+        // it. Costs no thread, see SequencedTaskQueue. Returns null if `pool`
+        // is not a thread pool queue.
+        static std::unique_ptr<TaskQueue> CreateSequenced(std::string_view name, TaskQueue* pool);
+
         // Used for DCHECKing the current queue.
         bool IsCurrent() const;
 
@@ -77,6 +90,9 @@ namespace core {
        // Ownership of the task is passed to PostTask.
         void PostTask(std::unique_ptr<QueuedTask> task);
 
+        // See TaskQueueBase::PostTaskWithPriority.
+        void PostTask(std::unique_ptr<QueuedTask> task, TaskPriority priority);
+
         // Schedules a task to execute a specified number of milliseconds from when
         // the call is made. The precision should be considered as "best effort"
         // and in some cases, such as on Windows when all high precision timers have
@@ -84,6 +100,11 @@ namespace core {
         // more likely). This can be mitigated by limiting the use of delayed tasks.
         void PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay);
 
+        // Same as PostDelayedTask, but the task runs as close to its deadline as
+        // the platform allows rather than on the next millisecond boundary, at
+        // the cost of more wake-ups. Meant for pacing, not for timeouts.
+        void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay);
+
 
         // std::enable_if is used here to make sure that calls to PostTask() with
         // std::unique_ptr<SomeClassDerivedFromQueuedTask> would not end up being
@@ -2,11 +2,19 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include "queued_task.h"
 #include "time_delta.h"
 
 namespace core {
 
+    // Lanes of the task queues that support them, see PostTaskWithPriority.
+    enum class TaskPriority {
+        kHigh = 0,
+        kNormal = 1,
+        kLow = 2
+    };
+
     // Asynchronously executes tasks in a way that guarantees that they're executed
     // in FIFO order and that tasks never overlap. Tasks may always execute on the
     // same worker thread and they may not. To DCHECK that tasks are executing on a
@@ -34,12 +42,25 @@ namespace core {
         // lifetimes of pending tasks should not be made.
         virtual void PostTask(std::unique_ptr<QueuedTask> task) = 0;
 
+        // Like PostTask, but the task goes to the lane of `priority`: pending
+        // tasks of a higher priority run first, and those of the same priority
+        // in FIFO order. Implementations guard lower priorities against
+        // starvation. Queues without lanes run the task as if posted by
+        // PostTask, which is also what kNormal does.
+        virtual void PostTaskWithPriority(std::unique_ptr<QueuedTask> task, TaskPriority priority) {
+            (void)priority;
+            PostTask(std::move(task));
+        }
+
         // Schedules a task to execute a specified number of milliseconds from when
         // the call is made. The precision should be considered as "best effort"
         // and in some cases, such as on Windows when all high precision timers have
         // been used up, can be off by as much as 15 millseconds.
         virtual void PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) = 0;
 
+        // Like PostDelayedTask, but the task should run as close to its deadline as
+        // the implementation can manage, even at the cost of extra wake-ups or
+        // CPU time. Low precision tasks may be batched on coarser boundaries.
         virtual void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) = 0;
 
         // Returns the task queue that is running the current thread.
@@ -33,10 +33,44 @@ namespace core {
         }
     }
 
+    void TaskQueueManager::createThreadPool(const std::string& name, size_t threads)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!exist(name)) {
+            m_queueMap[name] = TaskQueue::CreateThreadPool(name, threads);
+            m_threadPools.insert(name);
+        }
+    }
+
+    void TaskQueueManager::createSequenced(const std::vector<std::string>& nameList, const std::string& poolName)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_threadPools.count(poolName) == 0) {
+            return;
+        }
+        TaskQueue* pool = m_queueMap[poolName].get();
+        for (const auto& name : nameList) {
+            if (!exist(name)) {
+                if (auto queue = TaskQueue::CreateSequenced(name, pool)) {
+                    m_queueMap[name] = std::move(queue);
+                }
+            }
+        }
+    }
+
     void TaskQueueManager::clear()
     {
         std::unique_lock<std::mutex> lock(m_mutex);
+        // Sequenced queues first, the pools they run on must outlive them.
+        for (auto it = m_queueMap.begin(); it != m_queueMap.end();) {
+            if (m_threadPools.count(it->first) == 0) {
+                it = m_queueMap.erase(it);
+            } else {
+                ++it;
+            }
+        }
         m_queueMap.clear();
+        m_threadPools.clear();
     }
 
     bool TaskQueueManager::exist(const std::string& name)
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <stddef.h>
 #include <memory>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 
 namespace core {
@@ -18,6 +20,15 @@ namespace core {
 
         void create(const std::vector<std::string>& nameList);
 
+        // Creates a queue backed by a work stealing pool of `threads` workers, 0
+        // meaning one per hardware thread. Does nothing if the name is taken.
+        void createThreadPool(const std::string& name, size_t threads = 0);
+
+        // Creates sequenced queues sharing the workers of the pool created as
+        // `poolName` with createThreadPool. Does nothing if there is no such
+        // pool, names already taken are skipped.
+        void createSequenced(const std::vector<std::string>& nameList, const std::string& poolName);
+
         TaskQueue* queue(const std::string& name);
 
         bool hasQueue(const std::string& name);
@@ -43,6 +54,8 @@ namespace core {
 
         std::unordered_map<std::string, std::unique_ptr<TaskQueue>> m_queueMap;
 
+        std::unordered_set<std::string> m_threadPools;
+
     };
 
 }
@@ -1,12 +1,14 @@
 #include "task_queue_stdlib.h"
 #include <assert.h>
+#include <tuple>
 #include "time_utils.h"
-#include "divide_round.h"
 
 namespace core {
 
-    TaskQueueStdlib::TaskQueueStdlib(std::string_view queue_name)
+    TaskQueueStdlib::TaskQueueStdlib(std::string_view queue_name, TimeDelta high_precision_spin)
     : flag_notify_(/*manual_reset=*/false, /*initially_signaled=*/false)
+    , delayed_queue_(TimeMicros())
+    , high_precision_spin_(high_precision_spin)
     , name_(queue_name) {
         thread_ = std::thread([this]{
             CurrentTaskQueueSetter setCurrent(this);
@@ -26,10 +28,7 @@ namespace core {
     void TaskQueueStdlib::Delete() {
         assert(!IsCurrent());
 
-        {
-            std::unique_lock<std::mutex> lock(pending_lock_);
-            thread_should_quit_ = true;
-        }
+        thread_should_quit_.store(true);
 
         NotifyWake();
 
@@ -37,29 +36,43 @@ namespace core {
     }
 
     void TaskQueueStdlib::PostTask(std::unique_ptr<QueuedTask> task) {
-        {
-            std::unique_lock<std::mutex> lock(pending_lock_);
-            pending_queue_.push(std::make_pair(++thread_posting_order_, std::move(task)));
+        PostTaskWithPriority(std::move(task), TaskPriority::kNormal);
+    }
+
+    void TaskQueueStdlib::PostTaskWithPriority(std::unique_ptr<QueuedTask> task, TaskPriority priority) {
+        const int lane = static_cast<int>(priority);
+        incoming_[lane].push(std::move(task), ++thread_posting_order_);
+        if (priority != TaskPriority::kNormal) {
+            posted_lanes_.fetch_or(1u << lane);
         }
 
         NotifyWake();
     }
 
     void TaskQueueStdlib::PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) {
-        DelayedEntryTimeout delayed_entry;
-        delayed_entry.next_fire_at_us = TimeMicros() + delay.us();
+        const int64_t fire_at_us = TimeMicros() + delay.us();
 
         {
-            std::unique_lock<std::mutex> lock(pending_lock_);
-            delayed_entry.order = ++thread_posting_order_;
-            delayed_queue_[delayed_entry] = std::move(task);
+            std::unique_lock<std::mutex> lock(delayed_lock_);
+            delayed_queue_.Insert(std::move(task), fire_at_us, ++thread_posting_order_);
+            has_delayed_.store(true, std::memory_order_relaxed);
         }
+        ++delayed_generation_;
 
         NotifyWake();
     }
 
     void TaskQueueStdlib::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) {
-        PostDelayedTask(std::move(task), delay);
+        const int64_t fire_at_us = TimeMicros() + delay.us();
+
+        {
+            std::unique_lock<std::mutex> lock(delayed_lock_);
+            precise_queue_.push(std::move(task), fire_at_us, ++thread_posting_order_);
+            has_delayed_.store(true, std::memory_order_relaxed);
+        }
+        ++delayed_generation_;
+
+        NotifyWake();
     }
 
     const std::string& TaskQueueStdlib::Name() const {
@@ -69,50 +82,121 @@ namespace core {
     TaskQueueStdlib::NextTask TaskQueueStdlib::GetNextTask() {
         NextTask result;
 
-        const int64_t tick_us = TimeMicros();
-
-        std::unique_lock<std::mutex> lock(pending_lock_);
-
-        if (thread_should_quit_) {
+        if (thread_should_quit_.load(std::memory_order_acquire)) {
             result.final_task = true;
             return result;
         }
 
-        if (delayed_queue_.size() > 0) {
-            auto delayed_entry = delayed_queue_.begin();
-            const auto& delay_info = delayed_entry->first;
-            auto& delay_run = delayed_entry->second;
-            if (tick_us >= delay_info.next_fire_at_us) {
-                if (pending_queue_.size() > 0) {
-                    auto& entry = pending_queue_.front();
-                    auto& entry_order = entry.first;
-                    auto& entry_run = entry.second;
-                    if (entry_order < delay_info.order) {
-                        result.run_task = std::move(entry_run);
-                        pending_queue_.pop();
+        // Refill the pending queues with everything posted since their last
+        // refill, one atomic exchange per batch rather than a lock per task.
+        const int normal_lane = static_cast<int>(TaskPriority::kNormal);
+        if (pending_queue_[normal_lane].empty()) {
+            pending_queue_[normal_lane].append(incoming_[normal_lane].take_all());
+        }
+        // The other lanes are refilled as soon as something is posted to them,
+        // so that a high priority task does not wait for the lane to run out.
+        if (posted_lanes_.load(std::memory_order_relaxed)) {
+            const uint32_t lanes = posted_lanes_.exchange(0);
+            for (int lane = 0; lane < kLanes; ++lane) {
+                if (lanes & (1u << lane)) {
+                    pending_queue_[lane].append(incoming_[lane].take_all());
+                }
+            }
+        }
+
+        const int lane = NextLane();
+
+        if (has_delayed_.load(std::memory_order_relaxed)) {
+            const int64_t tick_us = TimeMicros();
+
+            std::unique_lock<std::mutex> lock(delayed_lock_);
+
+            delayed_queue_.Advance(tick_us);
+            QueuedTask* delayed_task = delayed_queue_.front();
+            QueuedTask* precise_task = nullptr;
+            if (!precise_queue_.empty() && precise_queue_.front()->fire_at_us_ <= tick_us) {
+                precise_task = precise_queue_.front();
+                if (delayed_task &&
+                    std::tie(delayed_task->fire_at_us_, delayed_task->order_) <
+                    std::tie(precise_task->fire_at_us_, precise_task->order_)) {
+                    precise_task = nullptr;
+                }
+            }
+
+            if (QueuedTask* due_task = precise_task ? precise_task : delayed_task) {
+                // A due task ranks as a normal one posted when it fell due, and
+                // is passed over by the high lane as many times as those.
+                if (lane >= 0) {
+                    const bool pending_first =
+                        (lane < normal_lane && passed_over_[normal_lane] < kMaxPassedOver) ||
+                        (lane == normal_lane && pending_queue_[lane].front()->order_ < due_task->order_) ||
+                        (lane > normal_lane && passed_over_[lane] >= kMaxPassedOver);
+                    if (pending_first) {
+                        PassOver(lane, true);
+                        result.run_task = pending_queue_[lane].pop();
                         return result;
                     }
                 }
 
-                result.run_task = std::move(delay_run);
-                delayed_queue_.erase(delayed_entry);
+                PassOver(normal_lane);
+                result.run_task = precise_task ? precise_queue_.pop() : delayed_queue_.pop();
+                has_delayed_.store(!delayed_queue_.empty() || !precise_queue_.empty(),
+                                   std::memory_order_relaxed);
                 return result;
             }
 
-            result.sleep_time = TimeDelta::Millis(DivideRoundUp(delay_info.next_fire_at_us - tick_us, 1'000));
+            // Low precision tasks wake the worker on the millisecond ticks of the
+            // wheel, high precision ones to the microsecond.
+            if (!delayed_queue_.empty()) {
+                result.sleep_time = TimeDelta::Micros(delayed_queue_.NextWakeUpUs() - tick_us);
+            }
+            if (!precise_queue_.empty()) {
+                const TimeDelta remaining = TimeDelta::Micros(precise_queue_.front()->fire_at_us_ - tick_us);
+                if (remaining <= high_precision_spin_) {
+                    result.spin = true;
+                } else {
+                    result.sleep_time = std::min(result.sleep_time, remaining - high_precision_spin_);
+                }
+            }
         }
 
-        if (pending_queue_.size() > 0) {
-            auto& entry = pending_queue_.front();
-            result.run_task = std::move(entry.second);
-            pending_queue_.pop();
+        if (lane >= 0) {
+            PassOver(lane);
+            result.run_task = pending_queue_[lane].pop();
         }
 
         return result;
     }
 
+    int TaskQueueStdlib::NextLane() const {
+        int next = -1;
+        for (int lane = 0; lane < kLanes; ++lane) {
+            if (pending_queue_[lane].empty()) {
+                continue;
+            }
+            if (next < 0) {
+                next = lane;
+            } else if (passed_over_[lane] >= kMaxPassedOver) {
+                return lane;
+            }
+        }
+        return next;
+    }
+
+    void TaskQueueStdlib::PassOver(int lane, bool delayed_due) {
+        const int normal_lane = static_cast<int>(TaskPriority::kNormal);
+        passed_over_[lane] = 0;
+        for (int lower = lane + 1; lower < kLanes; ++lower) {
+            if (!pending_queue_[lower].empty() || (lower == normal_lane && delayed_due)) {
+                ++passed_over_[lower];
+            }
+        }
+    }
+
     void TaskQueueStdlib::ProcessTasks() {
         while (true) {
+            const uint64_t delayed_generation = delayed_generation_.load();
+
             auto task = GetNextTask();
 
             if (task.final_task)
@@ -128,35 +212,81 @@ namespace core {
                 continue;
             }
 
+            if (task.spin) {
+                // Too close to a high precision deadline to risk sleeping past it.
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Announce that we are going to sleep, then look again: a poster
+            // either sees the flag and signals the event, or posted early enough
+            // for us to see its task here.
+            parked_.store(true);
+            if (HasNewWork(delayed_generation)) {
+                parked_.store(false);
+                continue;
+            }
+
             flag_notify_.Wait(task.sleep_time);
+            parked_.store(false);
         }
     }
 
+    bool TaskQueueStdlib::HasNewWork(uint64_t delayed_generation) const {
+        for (const IncomingTaskStack& incoming : incoming_) {
+            if (!incoming.empty()) {
+                return true;
+            }
+        }
+        return thread_should_quit_.load() ||
+               delayed_generation_.load() != delayed_generation;
+    }
+
+    TaskQueueStdlib::PreciseQueue::~PreciseQueue() {
+        for (QueuedTask* task : heap_) {
+            delete task;
+        }
+    }
+
+    bool TaskQueueStdlib::PreciseQueue::FiresAfter(const QueuedTask* a, const QueuedTask* b) {
+        return std::tie(a->fire_at_us_, a->order_) > std::tie(b->fire_at_us_, b->order_);
+    }
+
+    void TaskQueueStdlib::PreciseQueue::push(std::unique_ptr<QueuedTask> task, int64_t fire_at_us, OrderId order) {
+        QueuedTask* t = task.release();
+        t->fire_at_us_ = fire_at_us;
+        t->order_ = order;
+        heap_.push_back(t);
+        std::push_heap(heap_.begin(), heap_.end(), FiresAfter);
+    }
+
+    std::unique_ptr<QueuedTask> TaskQueueStdlib::PreciseQueue::pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), FiresAfter);
+        QueuedTask* t = heap_.back();
+        heap_.pop_back();
+        return std::unique_ptr<QueuedTask>(t);
+    }
+
     void TaskQueueStdlib::NotifyWake() {
         // The queue holds pending tasks to complete. Either tasks are to be
         // executed immediately or tasks are to be run at some future delayed time.
-        // For immediate tasks the task queue's thread is busy running the task and
-        // the thread will not be waiting on the flag_notify_ event. If no immediate
-        // tasks are available but a delayed task is pending then the thread will be
-        // waiting on flag_notify_ with a delayed time-out of the nearest timed task
-        // to run. If no immediate or pending tasks are available, the thread will
-        // wait on flag_notify_ until signaled that a task has been added (or the
-        // thread to be told to shutdown).
-
-        // In all cases, when a new immediate task, delayed task, or request to
-        // shutdown the thread is added the flag_notify_ is signaled after. If the
-        // thread was waiting then the thread will wake up immediately and re-assess
-        // what task needs to be run next (i.e. run a task now, wait for the nearest
-        // timed delayed task, or shutdown the thread). If the thread was not waiting
-        // then the thread will remained signaled to wake up the next time any
-        // attempt to wait on the flag_notify_ event occurs.
-
-        // Any immediate or delayed pending task (or request to shutdown the thread)
-        // must always be added to the queue prior to signaling flag_notify_ to wake
-        // up the possibly sleeping thread. This prevents a race condition where the
-        // thread is notified to wake up but the task queue's thread finds nothing to
-        // do so it waits once again to be signaled where such a signal may never
-        // happen.
-        flag_notify_.Set();
+        // While the worker is busy running tasks it never waits on flag_notify_,
+        // and it looks at the incoming stack and the delayed queue again before
+        // it parks, so there is nothing to signal.
+
+        // Before waiting, the worker sets parked_ and then checks once more for
+        // new immediate tasks, new delayed tasks or a request to shutdown. Posters
+        // add their work first and check parked_ after, both sequentially
+        // consistent, so at least one side sees the other: either the worker
+        // finds the new work and does not wait, or the poster finds the worker
+        // parked and signals flag_notify_. Only the poster that clears parked_
+        // signals, so a burst of posts wakes the worker at most once.
+
+        // A stale signal, e.g. when the worker woke up on its own for a delayed
+        // task, only makes the next wait return early, after which the worker
+        // re-assesses what to do as usual.
+        if (parked_.load() && parked_.exchange(false)) {
+            flag_notify_.Set();
+        }
     }
 }
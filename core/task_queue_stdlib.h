@@ -1,89 +1,162 @@
-#pragma once
-
-#include <string.h>
-#include <algorithm>
-#include <map>
-#include <memory>
-#include <queue>
-#include <utility>
-#include <thread>
-#include <mutex>
-#include <string_view>
-#include "queued_task.h"
-#include "event.h"
-#include "task_queue_base.h"
-
-namespace core {
-    class TaskQueueStdlib final : public TaskQueueBase {
-    public:
-        TaskQueueStdlib(std::string_view queue_name);
-        ~TaskQueueStdlib() override;
-
-        void Delete() override;
-        void PostTask(std::unique_ptr<QueuedTask> task) override;
-        void PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) override;
-        void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) override;
-        const std::string& Name() const override;
-
-    private:
-        using OrderId = uint64_t;
-
-        struct DelayedEntryTimeout {
-            // TODO(bugs.webrtc.org/13756): Migrate to Timestamp.
-            int64_t next_fire_at_us{};
-            OrderId order{};
-
-            bool operator<(const DelayedEntryTimeout& o) const {
-                return std::tie(next_fire_at_us, order) <
-                       std::tie(o.next_fire_at_us, o.order);
-            }
-        };
-
-        struct NextTask {
-            bool final_task{false};
-            std::unique_ptr<QueuedTask> run_task;
-            TimeDelta sleep_time = Event::kForever;
-        };
-
-        NextTask GetNextTask();
-
-        void ProcessTasks();
-
-        void NotifyWake();
-
-        // Signaled whenever a new task is pending.
-        Event flag_notify_;
-
-        std::mutex pending_lock_;
-
-        // Indicates if the worker thread needs to shutdown now.
-        bool thread_should_quit_ = false;
-
-        // Holds the next order to use for the next task to be
-        // put into one of the pending queues.
-        OrderId thread_posting_order_ = 0;
-
-        // The list of all pending tasks that need to be processed in the
-        // FIFO queue ordering on the worker thread.
-        std::queue<std::pair<OrderId, std::unique_ptr<QueuedTask>>> pending_queue_;
-
-        // The list of all pending tasks that need to be processed at a future
-        // time based upon a delay. On the off change the delayed task should
-        // happen at exactly the same time interval as another task then the
-        // task is processed based on FIFO ordering. std::priority_queue was
-        // considered but rejected due to its inability to extract the
-        // move-only value out of the queue without the presence of a hack.
-        std::map<DelayedEntryTimeout, std::unique_ptr<QueuedTask>> delayed_queue_;
-
-        // Contains the active worker thread assigned to processing
-        // tasks (including delayed tasks).
-        // Placing this last ensures the thread doesn't touch uninitialized attributes
-        // throughout it's lifetime.
-        std::thread thread_;
-
-        std::string name_;
-
-        Event started_;
-    };
-}
-
+#pragma once
+
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "pending_task_list.h"
+#include "queued_task.h"
+#include "event.h"
+#include "task_queue_base.h"
+#include "timer_wheel.h"
+
+namespace core {
+    class TaskQueueStdlib final : public TaskQueueBase {
+    public:
+        // High precision delayed tasks are waited for until `high_precision_spin`
+        // before their deadline, and the worker yields in a loop for the rest of
+        // the way, absorbing the wake-up slack of the OS. Zero disables spinning.
+        static constexpr TimeDelta kDefaultHighPrecisionSpin = TimeDelta::Micros(100);
+
+        TaskQueueStdlib(std::string_view queue_name,
+                        TimeDelta high_precision_spin = kDefaultHighPrecisionSpin);
+        ~TaskQueueStdlib() override;
+
+        void Delete() override;
+        void PostTask(std::unique_ptr<QueuedTask> task) override;
+        void PostTaskWithPriority(std::unique_ptr<QueuedTask> task, TaskPriority priority) override;
+        void PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) override;
+        void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) override;
+        const std::string& Name() const override;
+
+    private:
+        using OrderId = uint64_t;
+
+        static constexpr int kLanes = 3;
+
+        // Number of tasks of higher lanes a pending task may be passed over by
+        // before its lane gets to run one, so that a busy high lane slows the
+        // lower ones down instead of starving them.
+        static constexpr int kMaxPassedOver = 8;
+
+        struct NextTask {
+            bool final_task{false};
+            std::unique_ptr<QueuedTask> run_task;
+            TimeDelta sleep_time = Event::kForever;
+            // A high precision task is due within the spin window.
+            bool spin{false};
+        };
+
+        NextTask GetNextTask();
+
+        void ProcessTasks();
+
+        void NotifyWake();
+
+        // Returns true if something happened since the worker last looked for
+        // work, `delayed_generation` being the value it read at that point.
+        bool HasNewWork(uint64_t delayed_generation) const;
+
+        // Lane of the next pending task to run, -1 if there is none: the highest
+        // non-empty lane, unless a lower one has been passed over for too long,
+        // the highest of those then.
+        int NextLane() const;
+
+        // Accounts for a task of `lane` about to run. Due delayed tasks count as
+        // normal ones, `delayed_due` telling whether one is passed over.
+        void PassOver(int lane, bool delayed_due = false);
+
+        // Signaled whenever a new task is pending while the worker is parked.
+        Event flag_notify_;
+
+        // Set by the worker right before it waits on flag_notify_. Posters only
+        // signal the event when they are the first to see the worker parked, so
+        // posting to a busy worker costs no lock and no syscall.
+        std::atomic<bool> parked_{false};
+
+        // Bumped whenever a delayed task is posted, so that a worker about to
+        // park notices a delayed task it may have missed.
+        std::atomic<uint64_t> delayed_generation_{0};
+
+        // Guards the delayed queues, the immediate tasks go through the lock-free
+        // incoming stack instead.
+        std::mutex delayed_lock_;
+
+        // Indicates if the worker thread needs to shutdown now.
+        std::atomic<bool> thread_should_quit_{false};
+
+        // Holds the next order to use for the next task to be
+        // put into one of the pending queues.
+        std::atomic<OrderId> thread_posting_order_{0};
+
+        // Tasks posted since the worker last ran out of pending tasks, one
+        // stack per priority lane.
+        IncomingTaskStack incoming_[kLanes];
+
+        // Bit set of the lanes other than the normal one that had tasks posted
+        // since the worker last refilled them, so that the worker only has one
+        // word to look at as long as all tasks are normal ones.
+        std::atomic<uint32_t> posted_lanes_{0};
+
+        // The lists of all pending tasks that need to be processed in the
+        // FIFO queue ordering on the worker thread, one per priority lane. Only
+        // touched by the worker thread, which refills them from incoming_ in
+        // batches.
+        PendingTaskList pending_queue_[kLanes];
+
+        // Per lane, number of tasks run from higher lanes since the pending
+        // tasks of the lane last got to run. Only touched by the worker thread.
+        int passed_over_[kLanes] = {};
+
+        // All pending tasks that need to be processed at a future time based upon
+        // a delay. Tasks falling due at exactly the same time are processed based
+        // on FIFO ordering. A timer wheel rather than an ordered container, so
+        // that posting is O(1) and does not allocate.
+        TimerWheel delayed_queue_;
+
+        // Min-heap of high precision delayed tasks, ordered by fire time then
+        // order. Unlike delayed_queue_, fires to the microsecond. Owns the tasks
+        // it holds.
+        class PreciseQueue {
+        public:
+            PreciseQueue() = default;
+            PreciseQueue(const PreciseQueue&) = delete;
+            PreciseQueue& operator=(const PreciseQueue&) = delete;
+            ~PreciseQueue();
+
+            bool empty() const { return heap_.empty(); }
+            QueuedTask* front() const { return heap_.front(); }
+            void push(std::unique_ptr<QueuedTask> task, int64_t fire_at_us, OrderId order);
+            std::unique_ptr<QueuedTask> pop();
+
+        private:
+            static bool FiresAfter(const QueuedTask* a, const QueuedTask* b);
+
+            std::vector<QueuedTask*> heap_;
+        };
+
+        PreciseQueue precise_queue_;
+
+        const TimeDelta high_precision_spin_;
+
+        // Mirrors !delayed_queue_.empty() || !precise_queue_.empty(), lets the
+        // worker skip delayed_lock_ while there are no delayed tasks.
+        std::atomic<bool> has_delayed_{false};
+
+        // Contains the active worker thread assigned to processing
+        // tasks (including delayed tasks).
+        // Placing this last ensures the thread doesn't touch uninitialized attributes
+        // throughout it's lifetime.
+        std::thread thread_;
+
+        std::string name_;
+
+        Event started_;
+    };
+}
+
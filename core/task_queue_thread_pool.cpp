@@ -0,0 +1,89 @@
+#include "task_queue_thread_pool.h"
+#include <assert.h>
+#include <utility>
+#include "task_queue_stdlib.h"
+
+namespace core {
+
+    namespace {
+
+        // Hands a delayed task over to the pool once it is due.
+        class ForwardTask final : public QueuedTask {
+        public:
+            ForwardTask(std::unique_ptr<QueuedTask> task, TaskQueueBase* target)
+            : task_(std::move(task))
+            , target_(target) {}
+
+        private:
+            bool run() override {
+                target_->PostTask(std::move(task_));
+                return true;
+            }
+
+            std::unique_ptr<QueuedTask> task_;
+            TaskQueueBase* const target_;
+        };
+
+    }  // namespace
+
+    TaskQueueThreadPool::TaskQueueThreadPool(std::string_view queue_name, size_t threads)
+    : name_(queue_name)
+    , pool_(threads,
+            [this](QueuedTask* task) { Run(task); },
+            [](QueuedTask* task) { delete task; }) {}
+
+    TaskQueueThreadPool::~TaskQueueThreadPool() = default;
+
+    void TaskQueueThreadPool::Delete() {
+        assert(!IsCurrent());
+
+        // Stop the timer first so that it no longer forwards to the pool, its
+        // pending tasks are deleted along with it.
+        TaskQueueBase* timer = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(timer_lock_);
+            timer = std::exchange(timer_, nullptr);
+        }
+        if (timer) {
+            timer->Delete();
+        }
+
+        delete this;
+    }
+
+    void TaskQueueThreadPool::PostTask(std::unique_ptr<QueuedTask> task) {
+        pool_.submit(task.release());
+    }
+
+    void TaskQueueThreadPool::PostTaskFair(std::unique_ptr<QueuedTask> task) {
+        pool_.submit_fair(task.release());
+    }
+
+    void TaskQueueThreadPool::PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) {
+        Timer()->PostDelayedTask(std::make_unique<ForwardTask>(std::move(task), this), delay);
+    }
+
+    void TaskQueueThreadPool::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) {
+        Timer()->PostDelayedHighPrecisionTask(std::make_unique<ForwardTask>(std::move(task), this), delay);
+    }
+
+    const std::string& TaskQueueThreadPool::Name() const {
+        return name_;
+    }
+
+    TaskQueueBase* TaskQueueThreadPool::Timer() {
+        std::unique_lock<std::mutex> lock(timer_lock_);
+        if (!timer_) {
+            timer_ = new TaskQueueStdlib(name_ + "-timer");
+        }
+        return timer_;
+    }
+
+    void TaskQueueThreadPool::Run(QueuedTask* task) {
+        CurrentTaskQueueSetter setCurrent(this);
+        if (task->run()) {
+            delete task;
+        }
+    }
+
+}
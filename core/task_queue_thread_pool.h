@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "queued_task.h"
+#include "task_queue_base.h"
+#include "work_stealing_pool.h"
+
+namespace core {
+
+    class TaskQueueStdlib;
+
+    // A task queue backed by a pool of worker threads scheduling tasks by work
+    // stealing, for CPU heavy work that should spread over all cores rather than
+    // serialize on one thread.
+    //
+    // Unlike other task queues, tasks are NOT executed in FIFO order and may run
+    // concurrently with each other. IsCurrent() is true on any of the workers
+    // while they run a task of this queue, so auto connections to the pool run
+    // directly when emitted from one of its tasks.
+    //
+    // Delayed tasks are kept by an internal TaskQueueStdlib, created on first
+    // use, which hands them to the pool when they are due.
+    class TaskQueueThreadPool final : public TaskQueueBase {
+    public:
+        TaskQueueThreadPool(std::string_view queue_name, size_t threads);
+        ~TaskQueueThreadPool() override;
+
+        void Delete() override;
+        void PostTask(std::unique_ptr<QueuedTask> task) override;
+        void PostDelayedTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) override;
+        void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, TimeDelta delay) override;
+        const std::string& Name() const override;
+
+        // Like PostTask, but the task runs after all the tasks already waiting
+        // instead of next on the calling worker. For tasks that give the worker
+        // up and re-post themselves to carry on later.
+        void PostTaskFair(std::unique_ptr<QueuedTask> task);
+
+        size_t threads() const { return pool_.size(); }
+
+    private:
+        TaskQueueBase* Timer();
+
+        void Run(QueuedTask* task);
+
+        std::string name_;
+
+        std::mutex timer_lock_;
+        TaskQueueBase* timer_ = nullptr;
+
+        // Last, so that the workers are started once everything else is set up
+        // and stopped before anything else goes away.
+        thread_pool::work_stealing_pool<QueuedTask> pool_;
+    };
+}
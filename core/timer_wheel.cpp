@@ -0,0 +1,169 @@
+#include "timer_wheel.h"
+#include <assert.h>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include "divide_round.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace core {
+
+    namespace {
+
+        // `bits` must not be 0.
+        int CountTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, bits);
+            return static_cast<int>(index);
+#else
+            return __builtin_ctzll(bits);
+#endif
+        }
+
+        uint64_t RotateRight(uint64_t bits, int shift) {
+            return shift == 0 ? bits : (bits >> shift) | (bits << (64 - shift));
+        }
+
+    }  // namespace
+
+    bool TimerWheel::FiresBefore(const QueuedTask* a, const QueuedTask* b) {
+        return std::tie(a->fire_at_us_, a->order_) < std::tie(b->fire_at_us_, b->order_);
+    }
+
+    TimerWheel::TimerWheel(int64_t now_us)
+    : current_tick_(now_us / kTickUs) {}
+
+    TimerWheel::~TimerWheel() {
+        for (auto& level : slots_) {
+            for (QueuedTask* task : level) {
+                while (task) {
+                    delete std::exchange(task, task->next_);
+                }
+            }
+        }
+        for (size_t i = expired_head_; i < expired_.size(); ++i) {
+            delete expired_[i];
+        }
+    }
+
+    void TimerWheel::Insert(std::unique_ptr<QueuedTask> task, int64_t fire_at_us, uint64_t order) {
+        QueuedTask* t = task.release();
+        t->fire_at_us_ = fire_at_us;
+        t->order_ = order;
+        if (DivideRoundUp(fire_at_us, kTickUs) < current_tick_) {
+            // Its tick has been processed already, it is due right away.
+            expired_.insert(std::upper_bound(expired_.begin() + expired_head_, expired_.end(), t, FiresBefore), t);
+        } else {
+            File(t);
+        }
+        ++size_;
+    }
+
+    void TimerWheel::File(QueuedTask* task) {
+        const int64_t tick = DivideRoundUp(task->fire_at_us_, kTickUs);
+        // Too far ahead tasks wait in the last slot and get filed again once
+        // that slot is cascaded.
+        const int64_t delta = std::min(tick - current_tick_, kMaxDelayTicks - 1);
+        assert(delta >= 0);
+
+        int level = 0;
+        while (delta >= (int64_t{1} << (kSlotBits * (level + 1)))) {
+            ++level;
+        }
+        const int slot = static_cast<int>(((current_tick_ + delta) >> (kSlotBits * level)) & (kSlots - 1));
+
+        task->next_ = slots_[level][slot];
+        slots_[level][slot] = task;
+        occupied_[level] |= uint64_t{1} << slot;
+    }
+
+    QueuedTask* TimerWheel::TakeSlot(int level, int slot) {
+        occupied_[level] &= ~(uint64_t{1} << slot);
+        return std::exchange(slots_[level][slot], nullptr);
+    }
+
+    int64_t TimerWheel::NextTick() const {
+        int64_t next = -1;
+        for (int level = 0; level < kLevels; ++level) {
+            if (!occupied_[level]) {
+                continue;
+            }
+            // First slot of this level from the first of its boundaries that is
+            // not processed yet, in circular order.
+            const int shift = kSlotBits * level;
+            const int64_t block = (current_tick_ + (int64_t{1} << shift) - 1) >> shift;
+            const int distance = CountTrailingZeros(
+                RotateRight(occupied_[level], static_cast<int>(block & (kSlots - 1))));
+            const int64_t tick = (block + distance) << shift;
+            if (next < 0 || tick < next) {
+                next = tick;
+            }
+        }
+        return next;
+    }
+
+    void TimerWheel::ProcessTick(int64_t tick) {
+        current_tick_ = tick;
+
+        // Cascade the upper levels whose boundary is reached, the highest first
+        // so that its tasks can cascade further down right away.
+        for (int level = kLevels - 1; level > 0; --level) {
+            const int shift = kSlotBits * level;
+            if (tick & ((int64_t{1} << shift) - 1)) {
+                continue;
+            }
+            QueuedTask* task = TakeSlot(level, static_cast<int>((tick >> shift) & (kSlots - 1)));
+            while (task) {
+                File(std::exchange(task, task->next_));
+            }
+        }
+
+        const size_t first = expired_.size();
+        QueuedTask* task = TakeSlot(0, static_cast<int>(tick & (kSlots - 1)));
+        while (task) {
+            expired_.push_back(std::exchange(task, task->next_));
+        }
+        std::sort(expired_.begin() + first, expired_.end(), FiresBefore);
+
+        current_tick_ = tick + 1;
+    }
+
+    void TimerWheel::Advance(int64_t now_us) {
+        const int64_t now_tick = now_us / kTickUs;
+        while (true) {
+            const int64_t tick = NextTick();
+            if (tick < 0 || tick > now_tick) {
+                break;
+            }
+            ProcessTick(tick);
+        }
+        // Nothing is due up to now_tick, so those ticks count as processed. The
+        // last one is left open for tasks that would be due by then already.
+        current_tick_ = std::max(current_tick_, now_tick);
+    }
+
+    QueuedTask* TimerWheel::front() const {
+        return expired_head_ < expired_.size() ? expired_[expired_head_] : nullptr;
+    }
+
+    std::unique_ptr<QueuedTask> TimerWheel::pop() {
+        assert(front());
+        QueuedTask* task = expired_[expired_head_++];
+        if (expired_head_ == expired_.size()) {
+            expired_.clear();
+            expired_head_ = 0;
+        }
+        task->next_ = nullptr;
+        --size_;
+        return std::unique_ptr<QueuedTask>(task);
+    }
+
+    int64_t TimerWheel::NextWakeUpUs() const {
+        return NextTick() * kTickUs;
+    }
+
+}  // namespace core
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include "queued_task.h"
+
+namespace core {
+
+    // Hierarchical timer wheel holding the delayed tasks of a task queue.
+    //
+    // Time is cut into 1 ms ticks. Level 0 has one slot per tick for the next 64
+    // ticks, each upper level has slots 64 times as wide as the level below, so
+    // four levels cover about 4.6 hours ahead; tasks further away are parked in
+    // the last slot and re-filed when it comes around. Tasks are linked through
+    // their QueuedTask hook, which makes Insert() O(1) and allocation free.
+    // When time advances, a slot of an upper level is cascaded to the levels
+    // below, and the level 0 slot of each elapsed tick is moved to the expired
+    // list, sorted by (fire time, order) like the std::map it replaces. Occupancy
+    // bitmaps let Advance() jump straight over empty ticks.
+    //
+    // A task is expired once the current time has reached the 1 ms tick its
+    // fire time rounds up to. Not thread safe, owns the tasks it holds.
+    class TimerWheel {
+    public:
+        explicit TimerWheel(int64_t now_us);
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+        ~TimerWheel();
+
+        // Returns true if there is neither a pending nor an expired task.
+        bool empty() const { return size_ == 0; }
+
+        void Insert(std::unique_ptr<QueuedTask> task, int64_t fire_at_us, uint64_t order);
+
+        // Expires all the tasks whose tick is reached at `now_us`.
+        void Advance(int64_t now_us);
+
+        // Earliest expired task, nullptr if none.
+        QueuedTask* front() const;
+        std::unique_ptr<QueuedTask> pop();
+
+        // Time at which Advance() may next expire a task, or has to cascade an
+        // upper level. Only meaningful if there is no expired task and the wheel
+        // is not empty.
+        int64_t NextWakeUpUs() const;
+
+    private:
+        static constexpr int kLevels = 4;
+        static constexpr int kSlotBits = 6;
+        static constexpr int kSlots = 1 << kSlotBits;
+        static constexpr int64_t kTickUs = 1'000;
+        static constexpr int64_t kMaxDelayTicks = int64_t{1} << (kLevels * kSlotBits);
+
+        // Expiry order, by fire time then posting order.
+        static bool FiresBefore(const QueuedTask* a, const QueuedTask* b);
+
+        // Files a task in the slot matching its tick relative to current_tick_.
+        void File(QueuedTask* task);
+
+        // Next tick that has a level 0 slot to expire or an upper slot to
+        // cascade, -1 if the wheel holds no pending task.
+        int64_t NextTick() const;
+
+        void ProcessTick(int64_t tick);
+
+        QueuedTask* TakeSlot(int level, int slot);
+
+        // Next tick to be processed, all the earlier ones have been.
+        int64_t current_tick_;
+
+        QueuedTask* slots_[kLevels][kSlots] = {};
+        uint64_t occupied_[kLevels] = {};
+
+        // Expired tasks in firing order, from expired_head_ on. The storage is
+        // kept around so that steady state expiry does not allocate.
+        std::vector<QueuedTask*> expired_;
+        size_t expired_head_ = 0;
+
+        size_t size_ = 0;
+    };
+
+}  // namespace core
@@ -1,11 +1,22 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
 #include <cstring>
-#include <future>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <thread>
 #include <vector>
@@ -18,9 +29,11 @@
 #include <iostream>
 #include <assert.h>
 
-namespace core {
-    class TaskQueue;
-}
+#include "core/asymmetric_barrier.h"
+#include "core/event.h"
+#include "core/queued_task.h"
+#include "core/task_queue.h"
+#include "core/time_utils.h"
 
 namespace sigslot {
     //class i_executor;
@@ -156,10 +169,75 @@ namespace sigslot {
         direct_connection = 1,
         queued_connection = 2,
         blocking_queued_connection = 3,
+        // queued, but the slot has at most one pending call: emissions made
+        // before it runs overwrite the arguments it will be called with
+        coalesced_connection = 4,
+        // coalesced, and the slot runs at most once per interval, see throttle()
+        throttled_connection = 5,
+        // coalesced, and the slot only runs once emissions have paused for an
+        // interval, see debounce()
+        debounced_connection = 6,
+        // queued, but the slot holds at most a given number of pending calls,
+        // see bounded()
+        bounded_connection = 7,
+        // queued calls of the slot go to the high or low priority lane of task
+        // queues that have some, see core::TaskPriority
+        high_priority_connection = 0x20,
+        low_priority_connection = 0x40,
         unique_connection = 0x80,
         singleshot_connection = 0x100
     };
 
+    /**
+     * What a bounded connection does with an emission finding its slot with as
+     * many pending calls as it may hold.
+     */
+    enum overflow_policy {
+        drop_newest = 0,    // the emission is dropped
+        drop_oldest = 1,    // the oldest pending call is dropped to make room
+        block_emitter = 2,  // the emitter waits for room, unless it runs on the
+                            // queue of the slot, in which case it is dropped
+        call_directly = 3   // the slot is called on the emitting thread
+    };
+
+    /**
+     * Throttled, debounced and bounded connections carry their parameter in the
+     * upper bits of the connection type, an interval in milliseconds or a
+     * capacity, so that they can be given to connect() like any other type and
+     * combined with the other flags:
+     *
+     *   sig.connect(&obj, &Obj::onProgress, sigslot::throttle(50), queue);
+     *   sig.connect(&obj, &Obj::onChanged, sigslot::debounce(200) | sigslot::unique_connection, queue);
+     *   sig.connect(&obj, &Obj::onFrame, sigslot::bounded(64, sigslot::drop_oldest), queue);
+     *
+     * Parameters are capped to about a million, i.e. 17 minutes for intervals.
+     */
+    constexpr uint32_t connection_policy_shift = 9;
+    constexpr uint32_t connection_param_shift = 12;
+    constexpr uint32_t connection_param_max = (uint32_t{1} << (32 - connection_param_shift)) - 1;
+
+    // a coalesced connection whose slot runs on the leading edge of a burst of
+    // emissions then at most once every `milliseconds`, with the latest arguments
+    constexpr uint32_t throttle(uint32_t milliseconds) {
+        return connection_type::throttled_connection |
+               (std::min(milliseconds, connection_param_max) << connection_param_shift);
+    }
+
+    // a coalesced connection whose slot runs with the latest arguments once no
+    // emission happened for `milliseconds`
+    constexpr uint32_t debounce(uint32_t milliseconds) {
+        return connection_type::debounced_connection |
+               (std::min(milliseconds, connection_param_max) << connection_param_shift);
+    }
+
+    // a queued connection whose slot holds at most `capacity` pending calls,
+    // further emissions being handled according to `policy`
+    constexpr uint32_t bounded(uint32_t capacity, overflow_policy policy) {
+        return connection_type::bounded_connection |
+               (static_cast<uint32_t>(policy) << connection_policy_shift) |
+               (std::clamp(capacity, uint32_t{1}, connection_param_max) << connection_param_shift);
+    }
+
     /**
      * A group_id is used to identify a group of slots
      */
@@ -227,6 +305,24 @@ namespace sigslot {
                 return reinterpret_cast<const T*>(data);
             }
 
+            // nothing stored, the callable can not be compared
+            bool empty() const noexcept {
+                return sz == 0;
+            }
+
+            bool operator==(const func_ptr& o) const noexcept {
+                return sz == o.sz && std::memcmp(data, o.data, sz) == 0;
+            }
+
+            // FNV-1a over the stored bytes
+            std::size_t hash() const noexcept {
+                std::uint64_t h = 14695981039346656037ull;
+                for (size_t i = 0; i < sz; ++i) {
+                    h = (h ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+                }
+                return static_cast<std::size_t>(h);
+            }
+
         private:
             alignas(sizeof(mock::fun_types)) char data[sizeof(mock::fun_types)];
             size_t sz;
@@ -419,530 +515,2172 @@ namespace sigslot {
         };
 
         /**
-         * A simple copy on write container that will be used to improve slot lists
-         * access efficiency in a multithreaded context.
+         * Counts the blocking calls an emitter waits for, so that it can post
+         * several of them and wait once for them all. The count starts with one
+         * for the waiter itself, which gives it up when it waits: the event is
+         * then set by whoever brings the count to zero, once and only once.
+         * Single waiter, reusable once the wait has returned.
          */
-        template <typename T>
-        class copy_on_write {
-            struct payload {
-                payload() = default;
+        class latch {
+        public:
+            latch() = default;
+            latch(const latch&) = delete;
+            latch& operator=(const latch&) = delete;
 
-                template <typename... Args>
-                explicit payload(Args&& ...args)
-                : value(std::forward<Args>(args)...)
-                {}
+            void add() noexcept {
+                m_count.fetch_add(1, std::memory_order_relaxed);
+            }
 
-                std::atomic<std::size_t> count{1};
-                T value;
-            };
+            void arrive() noexcept {
+                if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    m_done.Set();
+                }
+            }
 
-        public:
-            using element_type = T;
+            void wait() {
+                if (m_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                    m_done.Wait(core::Event::kForever);
+                }
+                m_count.store(1, std::memory_order_relaxed);
+            }
 
-            copy_on_write()
-            : m_data(new payload)
-            {}
+        private:
+            std::atomic<int> m_count {1};
+            core::Event m_done;
+        };
 
-            template <typename U>
-            explicit copy_on_write(U&& x, std::enable_if_t<!std::is_same<std::decay_t<U>,
-                                                                         copy_on_write>::value>* = nullptr)
-            : m_data(new payload(std::forward<U>(x)))
-            {}
+        /**
+         * A bounded free list of task nodes, so that posting a call to a task queue
+         * does not allocate once the pool has warmed up. Call must expose an
+         * m_next pointer to chain idle nodes.
+         */
+        template <typename Call>
+        class call_pool {
+        public:
+            // number of idle calls kept around
+            static constexpr std::size_t max_size = 1024;
 
-            copy_on_write(const copy_on_write& x) noexcept
-            : m_data(x.m_data)
-            {
-                ++m_data->count;
+            call_pool() = default;
+            call_pool(const call_pool&) = delete;
+            call_pool& operator=(const call_pool&) = delete;
+
+            ~call_pool() {
+                while (m_head) {
+                    delete std::exchange(m_head, m_head->m_next);
+                }
             }
 
-            copy_on_write(copy_on_write&& x) noexcept
-            : m_data(x.m_data)
-            {
-                x.m_data = nullptr;
+            // returns nullptr if the pool is empty
+            Call* acquire() noexcept {
+                std::lock_guard<spin_mutex> lock(m_mutex);
+                if (!m_head) {
+                    return nullptr;
+                }
+                --m_size;
+                return std::exchange(m_head, m_head->m_next);
             }
 
-            ~copy_on_write() {
-                if (m_data && (--m_data->count == 0)) {
-                    delete m_data;
+            // returns false if the call must be deleted by its owner
+            bool release(Call *call) noexcept {
+                std::lock_guard<spin_mutex> lock(m_mutex);
+                if (m_size == max_size) {
+                    return false;
                 }
+                call->m_next = m_head;
+                m_head = call;
+                ++m_size;
+                return true;
             }
 
-            copy_on_write& operator=(const copy_on_write& x) noexcept {
-                if (&x != this) {
-                    *this = copy_on_write(x);
+        private:
+            spin_mutex m_mutex;
+            Call *m_head = nullptr;
+            std::size_t m_size = 0;
+        };
+
+        /**
+         * The arguments of an emission, materialized once for all of its queued
+         * slots. The block is immutable once built and reference counted, the last
+         * of the emission and its queued tasks to let go of it frees it. Blocks are
+         * pooled per argument list, like the tasks referring to them.
+         */
+        template <typename... Args>
+        class shared_args {
+        public:
+            using tuple_type = std::tuple<std::decay_t<Args>...>;
+
+            // returns a block holding a copy of u..., with a single reference
+            template <typename... U>
+            static shared_args* make(U&& ...u) {
+                shared_args *a = pool().acquire();
+                if (!a) {
+                    a = new shared_args;
                 }
-                return *this;
+                a->m_refs.store(1, std::memory_order_relaxed);
+                a->m_args.emplace(std::forward<U>(u)...);
+                return a;
             }
 
-            copy_on_write& operator=(copy_on_write&& x) noexcept  {
-                auto tmp = std::move(x);
-                swap(*this, tmp);
-                return *this;
+            void add_ref() noexcept {
+                m_refs.fetch_add(1, std::memory_order_relaxed);
             }
 
-            element_type& write() {
-                if (!unique()) {
-                    *this = copy_on_write(read());
-                }
-                return m_data->value;
+            // true once the caller holds the only reference left, the others
+            // being done reading the arguments
+            bool unique() const noexcept {
+                return m_refs.load(std::memory_order_acquire) == 1;
             }
 
-            const element_type& read() const noexcept {
-                return m_data->value;
+            void release() {
+                if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    m_args.reset();
+                    if (!pool().release(this)) {
+                        delete this;
+                    }
+                }
             }
 
-            friend inline void swap(copy_on_write& x, copy_on_write& y) noexcept {
-                using std::swap;
-                swap(x.m_data, y.m_data);
+            // slots get the arguments as lvalues and must not modify them, but for
+            // the last one, see unique()
+            tuple_type& args() noexcept {
+                return *m_args;
             }
 
         private:
-            bool unique() const noexcept {
-                return m_data->count == 1;
+            friend class call_pool<shared_args>;
+
+            // leaked on purpose, tasks may still be dropped by task queues
+            // during static destruction
+            static call_pool<shared_args>& pool() {
+                static auto *p = new call_pool<shared_args>;
+                return *p;
             }
 
-        private:
-            payload *m_data;
+            std::atomic<int> m_refs {0};
+            std::optional<tuple_type> m_args;
+            shared_args *m_next = nullptr;
         };
 
         /**
-         * Specializations for thread-safe code path
+         * A process-wide epoch based reclamation domain.
+         *
+         * Readers announce the epoch they entered in a thread local record, which
+         * never blocks and never writes to memory shared with other threads.
+         * Writers retire the memory they unpublished, it is reclaimed once every
+         * reader that may still observe it has left its critical section.
+         * Critical sections may nest, and may span several domains users.
+         *
+         * Reclamation is deterministic: memory retired while no reader may
+         * observe it is deleted before retire() returns, and otherwise by the
+         * last of those readers when it leaves. A thread may defer the deletions
+         * it triggers with a deferral, so that they run once it released its
+         * locks.
          */
-        template <typename T>
-        const T& cow_read(const T& v) {
-            return v;
-        }
-
-        template <typename T>
-        const T& cow_read(copy_on_write<T>& v) {
-            return v.read();
-        }
+        class epoch_domain {
+            // a cache line each, the readers of different threads never write
+            // to the same one
+            struct alignas(64) record {
+                std::atomic<std::uint64_t> epoch{0}; // 0 when the thread is quiescent
+                std::size_t nesting = 0;             // only touched by the owning thread
+                bool in_use = true;                  // guarded by the domain mutex
+            };
 
-        template <typename T>
-        T& cow_write(T& v) {
-            return v;
-        }
+            struct retired {
+                void *ptr;
+                void (*deleter)(void *);
+                std::uint64_t epoch;
+            };
 
-        template <typename T>
-        T& cow_write(copy_on_write<T>& v) {
-            return v.write();
-        }
+            struct thread_handle {
+                thread_handle() : rec(instance().acquire_record()) {}
+                ~thread_handle() { instance().release_record(rec); }
+                record *rec;
+            };
 
-/**
- * std::make_shared instantiates a lot a templates, and makes both compilation time
- * and executable size far bigger than they need to be. We offer a make_shared
- * equivalent that will avoid most instantiations with the following tradeoffs:
- * - Not exception safe,
- * - Allocates a separate control block, and will thus make the code slower.
- */
-#ifdef SIGSLOT_REDUCE_COMPILE_TIME
-        template <typename B, typename D, typename ...Arg>
-        inline std::shared_ptr<B> make_shared(Arg&& ... arg) {
-            return std::shared_ptr<B>(static_cast<B*>(new D(std::forward<Arg>(arg)...)));
-        }
-#else
-        template <typename B, typename D, typename ...Arg>
-        inline std::shared_ptr<B> make_shared(Arg&& ... arg) {
-            return std::static_pointer_cast<B>(std::make_shared<D>(std::forward<Arg>(arg)...));
-        }
-#endif
+            // the deletions a thread defers
+            struct deferred_list {
+                std::size_t depth = 0;
+                std::vector<retired> items;
+            };
 
-        /* slot_state holds slot type independent state, to be used to interact with
-         * slots indirectly through connection and scoped_connection objects.
-         */
-        class slot_state {
         public:
-            constexpr slot_state(group_id gid) noexcept
-            : m_index(0)
-            , m_group(gid)
-            , m_connected(true)
-            , m_blocked(false)
-            {}
+            static epoch_domain& instance() {
+                // leaked on purpose, threads may leave critical sections during
+                // static destruction
+                static epoch_domain *domain = new epoch_domain;
+                return *domain;
+            }
+
+            /**
+             * Defers the deletions the calling thread triggers until the
+             * outermost deferral of the thread goes away.
+             */
+            class deferral {
+            public:
+                deferral() noexcept {
+                    ++deferred().depth;
+                }
 
-            virtual ~slot_state() = default;
+                ~deferral() {
+                    auto &d = deferred();
+                    if (--d.depth == 0 && !d.items.empty()) {
+                        run(std::exchange(d.items, {}));
+                    }
+                }
 
-            virtual bool connected() const noexcept { return m_connected; }
+                deferral(const deferral&) = delete;
+                deferral& operator=(const deferral&) = delete;
+            };
 
-            bool disconnect() noexcept {
-                bool ret = m_connected.exchange(false);
-                if (ret) {
-                    do_disconnect();
+            void enter() noexcept {
+                record *r = local();
+                if (r->nesting++ == 0) {
+                    // sequentially consistent, pairs with try_advance(): either the
+                    // writer sees us, or we see what it published before scanning
+                    r->epoch.store(m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
                 }
-                return ret;
             }
 
-            bool blocked() const noexcept { return m_blocked.load(); }
-            void block()   noexcept { m_blocked.store(true); }
-            void unblock() noexcept { m_blocked.store(false); }
-
-        protected:
-            virtual void do_disconnect() {}
-
-            auto index() const {
-                return m_index;
+            void leave() {
+                record *r = local();
+                if (--r->nesting == 0) {
+                    const auto epoch = r->epoch.load(std::memory_order_relaxed);
+                    r->epoch.store(0, std::memory_order_release);
+                    // pairs with the heavy barrier of advance(): either the
+                    // writer sees us leave, or we see what it retired. A reader
+                    // that entered in the current epoch held no advance back.
+                    core::AsymmetricLightBarrier();
+                    if (m_pending.load(std::memory_order_relaxed) != 0 &&
+                        m_epoch.load(std::memory_order_relaxed) != epoch) {
+                        reclaim();
+                    }
+                }
             }
 
-            auto& index() {
-                return m_index;
-            }
+            // hand over an unpublished object for deletion once no reader may
+            // observe it anymore
+            template <typename T>
+            void retire(T *p) {
+                if (!p) {
+                    return;
+                }
 
-            group_id group() const {
-                return m_group;
+                std::vector<retired> ready;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_retired.push_back({p, [](void *q) { delete static_cast<T*>(q); },
+                                         m_epoch.load(std::memory_order_relaxed)});
+                    m_pending.store(m_retired.size(), std::memory_order_relaxed);
+                    advance(ready);
+                }
+                dispose(std::move(ready));
             }
 
         private:
-            template <typename, typename...>
-            friend class ::sigslot::signal_base;
-
-            std::size_t m_index;     // index into the array of slot pointers inside the signal
-            const group_id m_group;  // slot group this slot belongs to
-            std::atomic<bool> m_connected;
-            std::atomic<bool> m_blocked;
-        };
-
-    } // namespace detail
+            epoch_domain() = default;
 
-    /**
-     * connection_blocker is a RAII object that blocks a connection until destruction
-     */
-    class connection_blocker {
-    public:
-        connection_blocker() = default;
-        ~connection_blocker() noexcept { release(); }
+            static record* local() noexcept {
+                static thread_local thread_handle handle;
+                return handle.rec;
+            }
 
-        connection_blocker(const connection_blocker&) = delete;
-        connection_blocker& operator=(const connection_blocker&) = delete;
+            static deferred_list& deferred() noexcept {
+                static thread_local deferred_list list;
+                return list;
+            }
 
-        connection_blocker(connection_blocker&& o) noexcept
-        : m_state{std::move(o.m_state)}
-        {}
+            // deleters may run arbitrary destructors, which may retire in turn
+            static void run(std::vector<retired> ready) {
+                for (auto &r : ready) {
+                    r.deleter(r.ptr);
+                }
+            }
 
-        connection_blocker& operator=(connection_blocker&& o) noexcept {
-            release();
-            m_state.swap(o.m_state);
-            return *this;
-        }
+            // delete the objects now, or at the end of the deferral of the thread
+            static void dispose(std::vector<retired> ready) {
+                if (ready.empty()) {
+                    return;
+                }
+                auto &d = deferred();
+                if (d.depth != 0) {
+                    d.items.insert(d.items.end(), ready.begin(), ready.end());
+                    return;
+                }
+                run(std::move(ready));
+            }
 
-    private:
-        friend class connection;
-        explicit connection_blocker(std::weak_ptr<detail::slot_state> s) noexcept
-        : m_state{std::move(s)}
-        {
-            if (auto d = m_state.lock()) {
-                d->block();
+            // delete what the readers that left allow
+            void reclaim() {
+                std::vector<retired> ready;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    advance(ready);
+                }
+                dispose(std::move(ready));
+            }
+
+            // to be called under lock: move as many epochs forward as the readers
+            // allow, two being enough to collect all that was retired so far.
+            // Readers holding an epoch back reclaim when they leave, which the
+            // heavy barrier guarantees they see the need for, unless we see
+            // them leave once it is done.
+            void advance(std::vector<retired>& ready) {
+                int steps = 0;
+                while (steps < 2 && try_advance()) {
+                    ++steps;
+                }
+                if (steps < 2) {
+                    core::AsymmetricHeavyBarrier();
+                    while (steps < 2 && try_advance()) {
+                        ++steps;
+                    }
+                }
+                collect(ready);
+                m_pending.store(m_retired.size(), std::memory_order_relaxed);
             }
-        }
 
-        void release() noexcept {
-            if (auto d = m_state.lock()) {
-                d->unblock();
+            record* acquire_record() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (auto *r : m_records) {
+                    if (!r->in_use) {
+                        r->in_use = true;
+                        return r;
+                    }
+                }
+                m_records.push_back(new record);
+                return m_records.back();
             }
-        }
 
-    private:
-        std::weak_ptr<detail::slot_state> m_state;
-    };
+            void release_record(record *r) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                r->in_use = false;
+            }
 
+            // to be called under lock: move to the next epoch if every active
+            // reader has observed the current one
+            bool try_advance() {
+                const auto epoch = m_epoch.load(std::memory_order_relaxed);
+                for (const auto *r : m_records) {
+                    const auto e = r->epoch.load(std::memory_order_seq_cst);
+                    if (e != 0 && e != epoch) {
+                        return false;
+                    }
+                }
+                m_epoch.store(epoch + 1, std::memory_order_seq_cst);
+                return true;
+            }
 
-    /**
-     * A connection object allows interaction with an ongoing slot connection
-     *      * It allows common actions such as connection blocking and disconnection.
-     * Note that connection is not a RAII object, one does not need to hold one
-     * such object to keep the signal-slot connection alive.
-     */
-    class connection {
-    public:
-        connection() = default;
-        virtual ~connection() = default;
+            // to be called under lock: objects retired two epochs ago can no
+            // longer be reached by any reader
+            void collect(std::vector<retired>& ready) {
+                const auto epoch = m_epoch.load(std::memory_order_relaxed);
+                auto it = std::partition(m_retired.begin(), m_retired.end(), [&](const retired& r) {
+                    return r.epoch + 2 > epoch;
+                });
+                ready.assign(it, m_retired.end());
+                m_retired.erase(it, m_retired.end());
+            }
 
-        connection(const connection&) noexcept = default;
-        connection& operator=(const connection&) noexcept = default;
-        connection(connection&&) noexcept = default;
-        connection& operator=(connection&&) noexcept = default;
+        private:
+            std::mutex m_mutex;
+            std::atomic<std::uint64_t> m_epoch{1};
+            std::vector<record*> m_records;
+            std::vector<retired> m_retired;
+            std::atomic<std::size_t> m_pending{0};  // size of m_retired, read by leaving readers
+        };
 
-        bool valid() const noexcept {
-            return !m_state.expired();
-        }
+        template <typename T>
+        class copy_on_write;
 
-        bool connected() const noexcept {
-            const auto d = m_state.lock();
-            return d && d->connected();
-        }
+        /**
+         * A read-only view over the value published by a copy_on_write container.
+         * The view stays valid until destruction, acquiring it never blocks.
+         */
+        template <typename T>
+        class cow_snapshot {
+        public:
+            explicit cow_snapshot(const copy_on_write<T>& c) noexcept {
+                epoch_domain::instance().enter();
+                m_data = c.m_data.load(std::memory_order_seq_cst);
+            }
 
-        bool disconnect() noexcept {
-            auto d = m_state.lock();
-            return d && d->disconnect();
-        }
+            ~cow_snapshot() {
+                epoch_domain::instance().leave();
+            }
 
-        bool blocked() const noexcept {
-            const auto d = m_state.lock();
-            return d && d->blocked();
-        }
+            cow_snapshot(const cow_snapshot&) = delete;
+            cow_snapshot& operator=(const cow_snapshot&) = delete;
 
-        void block() noexcept {
-            if (auto d = m_state.lock()) {
-                d->block();
+            const T& read() const noexcept {
+                return m_data ? *m_data : copy_on_write<T>::empty();
             }
-        }
 
-        void unblock() noexcept {
-            if (auto d = m_state.lock()) {
-                d->unblock();
-            }
-        }
+        private:
+            const T *m_data;
+        };
 
-        connection_blocker blocker() const noexcept {
-            return connection_blocker{m_state};
+        /**
+         * A simple copy on write container that will be used to improve slot lists
+         * access efficiency in a multithreaded context.
+         *
+         * Readers take a cow_snapshot and never block. Writers must be serialized by
+         * the caller, they mutate a private copy which is then published atomically,
+         * the previous value being reclaimed through the epoch_domain.
+         *
+         * Nothing is allocated until the first write, an empty container is a null
+         * pointer that can be tested with a single relaxed load.
+         */
+        template <typename T>
+        class copy_on_write {
+        public:
+            using element_type = T;
+
+            copy_on_write() noexcept
+            : m_data(nullptr)
+            {}
+
+            ~copy_on_write() {
+                epoch_domain::instance().retire(m_data.load(std::memory_order_relaxed));
+            }
+
+            copy_on_write(const copy_on_write&) = delete;
+            copy_on_write& operator=(const copy_on_write&) = delete;
+
+            // to be called by a writer, serialized with other writers
+            template <typename F>
+            void write(F&& f) {
+                const auto *cur = m_data.load(std::memory_order_relaxed);
+                std::unique_ptr<T> copy(cur ? new T(*cur) : new T);
+                f(*copy);
+                publish(copy->empty() ? nullptr : copy.release());
+            }
+
+            // to be called by a writer, serialized with other writers
+            void reset() {
+                publish(nullptr);
+            }
+
+            // to be called by a writer, serialized with other writers
+            void assign(T&& value) {
+                publish(value.empty() ? nullptr : new T(std::move(value)));
+            }
+
+            // to be called by a writer, serialized with other writers
+            const element_type& read() const noexcept {
+                const auto *cur = m_data.load(std::memory_order_relaxed);
+                return cur ? *cur : empty();
+            }
+
+            // may be called concurrently with writers, as a hint only
+            bool unset() const noexcept {
+                return m_data.load(std::memory_order_relaxed) == nullptr;
+            }
+
+            friend inline void swap(copy_on_write& x, copy_on_write& y) noexcept {
+                auto *tmp = x.m_data.load(std::memory_order_relaxed);
+                x.m_data.store(y.m_data.load(std::memory_order_relaxed), std::memory_order_release);
+                y.m_data.store(tmp, std::memory_order_release);
+            }
+
+        private:
+            friend class cow_snapshot<T>;
+
+            static const T& empty() noexcept {
+                static const T e;
+                return e;
+            }
+
+            void publish(T *data) {
+                auto *old = m_data.exchange(data, std::memory_order_seq_cst);
+                epoch_domain::instance().retire(old);
+            }
+
+            std::atomic<T*> m_data;
+        };
+
+        /**
+         * Specializations for thread-safe code path
+         */
+        template <typename T>
+        const T& cow_read(const T& v) {
+            return v;
         }
 
-    protected:
-        template <typename, typename...> friend class signal_base;
-        explicit connection(std::weak_ptr<detail::slot_state> s) noexcept
-        : m_state{std::move(s)}
-        {}
+        template <typename T>
+        const T& cow_read(const copy_on_write<T>& v) {
+            return v.read();
+        }
 
-    protected:
-        std::weak_ptr<detail::slot_state> m_state;
-    };
+        template <typename T>
+        const T& cow_read(const cow_snapshot<T>& v) {
+            return v.read();
+        }
 
-    /**
-     * scoped_connection is a RAII version of connection
-     * It disconnects the slot from the signal upon destruction.
-     */
-    class scoped_connection final : public connection {
-    public:
-        scoped_connection() = default;
-        ~scoped_connection() override {
-            disconnect();
+        template <typename T, typename F>
+        void cow_write(T& v, F&& f) {
+            f(v);
         }
 
-        /*implicit*/ scoped_connection(const connection& c) noexcept : connection(c) {}
-        /*implicit*/ scoped_connection(connection&& c) noexcept : connection(std::move(c)) {}
+        template <typename T, typename F>
+        void cow_write(copy_on_write<T>& v, F&& f) {
+            v.write(std::forward<F>(f));
+        }
 
-        scoped_connection(const scoped_connection&) noexcept = delete;
-        scoped_connection& operator=(const scoped_connection&) noexcept = delete;
+        template <typename T>
+        void cow_reset(T& v) {
+            v.clear();
+        }
 
-        scoped_connection(scoped_connection&& o) noexcept
-        : connection{std::move(o.m_state)}
-        {}
+        template <typename T>
+        void cow_reset(copy_on_write<T>& v) {
+            v.reset();
+        }
 
-        scoped_connection& operator=(scoped_connection&& o) noexcept {
-            disconnect();
-            m_state.swap(o.m_state);
-            return *this;
+        template <typename T>
+        void cow_assign(T& v, T&& value) {
+            v = std::move(value);
         }
 
-    private:
-        template <typename, typename...> friend class signal_base;
-        explicit scoped_connection(std::weak_ptr<detail::slot_state> s) noexcept
-        : connection{std::move(s)}
-        {}
-    };
+        template <typename T>
+        void cow_assign(copy_on_write<T>& v, T&& value) {
+            v.assign(std::move(value));
+        }
 
-    /**
-     * Observer is a base class for intrusive lifetime tracking of objects.
-     *      * This is an alternative to trackable pointers, such as std::shared_ptr,
-     * and manual connection management by keeping connection objects in scope.
-     * Deriving from this class allows automatic disconnection of all the slots
-     * connected to any signal when an instance is destroyed.
-     */
-    template <typename Lockable>
-    struct observer_base : private detail::observer_type {
-        virtual ~observer_base() = default;
+        template <typename T>
+        bool cow_unset(const T& v) {
+            return v.empty();
+        }
+
+        template <typename T>
+        bool cow_unset(const copy_on_write<T>& v) {
+            return v.unset();
+        }
 
-    protected:
         /**
-         * Disconnect all signals connected to this object.
-         *          * To avoid invocation of slots on a semi-destructed instance, which may happen
-         * in multi-threaded contexts, derived classes should call this method in their
-         * destructor. This will ensure proper disconnection prior to the destruction.
+         * A vector stored as a list of fixed size chunks, which its copies share.
+         * Copying it only copies the chunk pointers, and a copy copies a chunk
+         * the first time it modifies it. The copy a copy_on_write writer makes
+         * thus costs one pointer per chunk plus the chunks it changes, rather
+         * than a copy of every element.
+         *
+         * A shared chunk is never modified, so the readers of a published copy
+         * do not see the changes a writer makes to its own copy. All the chunks
+         * but the last one are full, elements are read in sequence within a
+         * chunk. Chunks are reference counted atomically since the copies may
+         * be destroyed by any thread.
          */
-        void disconnect_all() {
-            std::unique_lock<Lockable> _{m_mutex};
-            m_connections.clear();
-        }
+        template <typename T, std::size_t ChunkSize = 64>
+        class chunked_vector {
+            static_assert((ChunkSize & (ChunkSize - 1)) == 0, "chunk size must be a power of 2");
 
-    private:
-        template <typename, typename ...>
-        friend class signal_base;
+            struct chunk {
+                chunk() = default;
 
-        void add_connection(connection conn) {
-            std::unique_lock<Lockable> _{m_mutex};
-            m_connections.emplace_back(std::move(conn));
-        }
+                chunk(const chunk& o) {
+                    for (; size < o.size; ++size) {
+                        new (data() + size) T(o.data()[size]);
+                    }
+                }
 
-        Lockable m_mutex;
-        std::vector<scoped_connection> m_connections;
-    };
+                chunk& operator=(const chunk&) = delete;
 
-    /**
-     * Specialization of observer_base to be used in single threaded contexts.
-     */
-    using observer_st = observer_base<detail::null_mutex>;
+                ~chunk() {
+                    for (std::size_t i = 0; i < size; ++i) {
+                        data()[i].~T();
+                    }
+                }
 
-    /**
-     * Specialization of observer_base to be used in multi-threaded contexts.
-     */
-    using observer = observer_base<std::mutex>;
+                T* data() noexcept {
+                    return reinterpret_cast<T*>(storage);
+                }
 
+                const T* data() const noexcept {
+                    return reinterpret_cast<const T*>(storage);
+                }
 
-    namespace detail {
+                std::atomic<std::size_t> refs{1};
+                std::size_t size = 0;
+                alignas(T) unsigned char storage[ChunkSize * sizeof(T)];
+            };
+
+        public:
+            class const_iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const T*;
+                using reference = const T&;
+
+                const T& operator*() const noexcept {
+                    return (*m_chunk)->data()[m_pos];
+                }
+
+                const T* operator->() const noexcept {
+                    return (*m_chunk)->data() + m_pos;
+                }
+
+                const_iterator& operator++() noexcept {
+                    if (++m_pos == (*m_chunk)->size) {
+                        ++m_chunk;
+                        m_pos = 0;
+                    }
+                    return *this;
+                }
+
+                const_iterator operator++(int) noexcept {
+                    auto it = *this;
+                    ++*this;
+                    return it;
+                }
+
+                bool operator==(const const_iterator& o) const noexcept {
+                    return m_chunk == o.m_chunk && m_pos == o.m_pos;
+                }
+
+                bool operator!=(const const_iterator& o) const noexcept {
+                    return !(*this == o);
+                }
+
+            private:
+                friend class chunked_vector;
+
+                const_iterator(chunk *const *c, std::size_t pos) noexcept
+                : m_chunk(c)
+                , m_pos(pos)
+                {}
+
+                chunk *const *m_chunk;
+                std::size_t m_pos;
+            };
+
+            chunked_vector() noexcept = default;
+
+            chunked_vector(const chunked_vector& o)
+            : m_chunks(o.m_chunks)
+            , m_size(o.m_size)
+            {
+                for (auto *c : m_chunks) {
+                    c->refs.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            chunked_vector(chunked_vector&& o) noexcept
+            : m_chunks(std::move(o.m_chunks))
+            , m_size(std::exchange(o.m_size, 0))
+            {
+                o.m_chunks.clear();
+            }
+
+            chunked_vector& operator=(const chunked_vector& o) {
+                if (this != &o) {
+                    chunked_vector tmp(o);
+                    swap(*this, tmp);
+                }
+                return *this;
+            }
+
+            chunked_vector& operator=(chunked_vector&& o) noexcept {
+                chunked_vector tmp(std::move(o));
+                swap(*this, tmp);
+                return *this;
+            }
+
+            ~chunked_vector() {
+                clear();
+            }
+
+            friend void swap(chunked_vector& x, chunked_vector& y) noexcept {
+                using std::swap;
+                swap(x.m_chunks, y.m_chunks);
+                swap(x.m_size, y.m_size);
+            }
+
+            std::size_t size() const noexcept {
+                return m_size;
+            }
+
+            bool empty() const noexcept {
+                return m_size == 0;
+            }
+
+            const T& operator[](std::size_t i) const noexcept {
+                return m_chunks[i / ChunkSize]->data()[i % ChunkSize];
+            }
+
+            const T& back() const noexcept {
+                const chunk *c = m_chunks.back();
+                return c->data()[c->size - 1];
+            }
+
+            const_iterator begin() const noexcept {
+                return const_iterator(m_chunks.data(), 0);
+            }
+
+            const_iterator end() const noexcept {
+                return const_iterator(m_chunks.data() + m_chunks.size(), 0);
+            }
+
+            // calls f with each element in order, faster than iterating
+            template <typename F>
+            void for_each(F&& f) const {
+                for (const chunk *c : m_chunks) {
+                    for (const T *e = c->data(), *end = e + c->size; e != end; ++e) {
+                        f(*e);
+                    }
+                }
+            }
+
+            template <typename... A>
+            void emplace_back(A&& ...a) {
+                if (m_chunks.empty() || m_chunks.back()->size == ChunkSize) {
+                    std::unique_ptr<chunk> c(new chunk);
+                    m_chunks.push_back(c.get());
+                    c.release();
+                }
+                chunk *c = own(m_chunks.size() - 1);
+                new (c->data() + c->size) T(std::forward<A>(a)...);
+                ++c->size;
+                ++m_size;
+            }
+
+            void pop_back() {
+                chunk *c = own(m_chunks.size() - 1);
+                c->data()[--c->size].~T();
+                --m_size;
+                if (c->size == 0) {
+                    release(c);
+                    m_chunks.pop_back();
+                }
+            }
+
+            // removes element i, replacing it with the last element
+            void swap_remove(std::size_t i) {
+                if (i + 1 != m_size) {
+                    T& hole = own(i / ChunkSize)->data()[i % ChunkSize];
+                    chunk *c = own(m_chunks.size() - 1);
+                    hole = std::move(c->data()[c->size - 1]);
+                }
+                pop_back();
+            }
+
+            void clear() noexcept {
+                for (auto *c : m_chunks) {
+                    release(c);
+                }
+                m_chunks.clear();
+                m_size = 0;
+            }
+
+        private:
+            // the chunk at index i, copied first if other vectors share it
+            chunk* own(std::size_t i) {
+                chunk *c = m_chunks[i];
+                if (c->refs.load(std::memory_order_acquire) != 1) {
+                    chunk *copy = new chunk(*c);
+                    release(c);
+                    m_chunks[i] = c = copy;
+                }
+                return c;
+            }
+
+            static void release(chunk *c) noexcept {
+                if (c->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete c;
+                }
+            }
+
+            std::vector<chunk*> m_chunks;
+            std::size_t m_size = 0;
+        };
+
+/**
+ * std::make_shared instantiates a lot a templates, and makes both compilation time
+ * and executable size far bigger than they need to be. We offer a make_shared
+ * equivalent that will avoid most instantiations with the following tradeoffs:
+ * - Not exception safe,
+ * - Allocates a separate control block, and will thus make the code slower.
+ */
+#ifdef SIGSLOT_REDUCE_COMPILE_TIME
+        template <typename B, typename D, typename ...Arg>
+        inline std::shared_ptr<B> make_shared(Arg&& ... arg) {
+            return std::shared_ptr<B>(static_cast<B*>(new D(std::forward<Arg>(arg)...)));
+        }
+#else
+        template <typename B, typename D, typename ...Arg>
+        inline std::shared_ptr<B> make_shared(Arg&& ... arg) {
+            return std::static_pointer_cast<B>(std::make_shared<D>(std::forward<Arg>(arg)...));
+        }
+#endif
+
+        class slot_state;
 
         // interface for cleanable objects, used to cleanup disconnected slots
         struct cleanable {
             virtual ~cleanable() = default;
             virtual void clean(slot_state *) = 0;
+            // cleans up several slots at once, all disconnected already
+            virtual void clean(slot_state *const *states, std::size_t count) = 0;
         };
 
-        template <typename...>
-        class slot_base;
-
-        template <typename... T>
-        using slot_ptr = std::shared_ptr<slot_base<T...>>;
-
-
-        /* A base class for slot objects. This base type only depends on slot argument
-         * types, it will be used as an element in an intrusive singly-linked list of
-         * slots, hence the public next member.
+        /*
+         * The list of the slots bound to an observer. Slots link themselves in
+         * when connected, through a node embedded in their state, and unlink
+         * themselves when disconnected or destroyed, so that the list only holds
+         * live connections. The list is reference counted by the observer and
+         * the slots linked to it at some point, since a slot going away may
+         * have to take its lock after the observer is gone.
          */
-        template <typename... Args>
-        class slot_base : public slot_state {
+        class observer_links {
         public:
-            using base_types = trait::typelist<Args...>;
+            observer_links() = default;
+            observer_links(const observer_links&) = delete;
+            observer_links& operator=(const observer_links&) = delete;
+            virtual ~observer_links() = default;
 
-            explicit slot_base(cleanable& c, uint32_t type, core::TaskQueue* queue, group_id gid)
-            : slot_state(gid)
-            , m_cleaner(c)
-            , m_queue(queue) {
-                m_singleshot = type & connection_type::singleshot_connection;
-                uint32_t t = type;
-                t &= ~connection_type::unique_connection;
-                t &= ~connection_type::singleshot_connection;
-                m_type = t;
+            void acquire() noexcept {
+                m_refs.fetch_add(1, std::memory_order_relaxed);
             }
 
-            ~slot_base() override = default;
+            void release() noexcept {
+                if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete this;
+                }
+            }
+
+            virtual void link(slot_state *s) = 0;
+
+            // does nothing if s is not linked
+            virtual void unlink(slot_state *s) noexcept = 0;
+
+        protected:
+            // to be called under the list lock
+            void push(slot_state *s) noexcept;
+            void remove(slot_state *s) noexcept;
+
+            slot_state *m_head = nullptr;
+
+        private:
+            std::atomic<std::size_t> m_refs{1};
+        };
+
+        /* slot_state holds slot type independent state, to be used to interact with
+         * slots indirectly through connection and scoped_connection objects.
+         */
+        class slot_state {
+        public:
+            constexpr slot_state(group_id gid) noexcept
+            : m_index(0)
+            , m_group(gid)
+            , m_connected(true)
+            , m_blocked(false)
+            {}
+
+            virtual ~slot_state() {
+                if (m_observer) {
+                    m_observer->unlink(this);
+                    m_observer->release();
+                }
+            }
+
+            virtual bool connected() const noexcept { return m_connected; }
+
+            bool disconnect() noexcept {
+                bool ret = m_connected.exchange(false);
+                if (ret) {
+                    do_disconnect();
+                }
+                return ret;
+            }
+
+            bool blocked() const noexcept { return m_blocked.load(); }
+            void block()   noexcept { m_blocked.store(true); }
+            void unblock() noexcept { m_blocked.store(false); }
+
+            // emissions dropped by the overflow policy of a bounded or coalesced
+            // connection, including the pending calls overwritten or dropped
+            // to make room
+            virtual uint64_t dropped_emissions() const noexcept { return 0; }
+
+            // emissions that held the emitting thread because a bounded
+            // connection was full, either waiting for room or calling the slot
+            virtual uint64_t blocked_emissions() const noexcept { return 0; }
+
+        protected:
+            virtual void do_disconnect() {}
+
+            // the signal to clean the slot up from once disconnected
+            virtual cleanable* cleaner() const noexcept { return nullptr; }
+
+            auto index() const {
+                return m_index;
+            }
+
+            auto& index() {
+                return m_index;
+            }
+
+            group_id group() const {
+                return m_group;
+            }
+
+            // to be called by the signal removing the slot: it is neither called
+            // nor cleaned up anymore, and leaves the list of its observer
+            void detach() noexcept {
+                m_connected.store(false);
+                if (m_observer) {
+                    m_observer->unlink(this);
+                }
+            }
+
+            // binds the slot to observer links l, to be called once before the
+            // slot is shared, self being the slot itself
+            void observe(observer_links& l, std::weak_ptr<slot_state> self) {
+                l.acquire();
+                m_observer = &l;
+                m_self = std::move(self);
+                l.link(this);
+            }
+
+        private:
+            template <typename, typename...>
+            friend class ::sigslot::signal_base;
+            friend class observer_links;
+            template <typename>
+            friend class observer_list;
+
+            std::size_t m_index;     // index into the array of slot pointers inside the signal
+            const group_id m_group;  // slot group this slot belongs to
+            std::atomic<bool> m_connected;
+            std::atomic<bool> m_blocked;
+
+            // node in the list of the observer the slot is bound to, if any.
+            // The links are guarded by the list lock. The observer locks the
+            // slot through m_self rather than a virtual call, since the slot may
+            // be under destruction.
+            observer_links *m_observer = nullptr;
+            slot_state *m_prev = nullptr;
+            slot_state *m_next = nullptr;
+            std::weak_ptr<slot_state> m_self;
+        };
+
+        inline void observer_links::push(slot_state *s) noexcept {
+            s->m_next = m_head;
+            if (m_head) {
+                m_head->m_prev = s;
+            }
+            m_head = s;
+        }
+
+        inline void observer_links::remove(slot_state *s) noexcept {
+            if (!s->m_prev && m_head != s) {
+                return;
+            }
+            if (s->m_prev) {
+                s->m_prev->m_next = s->m_next;
+            } else {
+                m_head = s->m_next;
+            }
+            if (s->m_next) {
+                s->m_next->m_prev = s->m_prev;
+            }
+            s->m_prev = s->m_next = nullptr;
+        }
+
+        /*
+         * observer_links guarded by a Lockable. Disconnecting all the slots
+         * empties the list under the lock, then disconnects the slots after
+         * releasing it, with one clean up per signal, so that the list lock is
+         * never held while taking that of a signal.
+         */
+        template <typename Lockable>
+        class observer_list final : public observer_links {
+        public:
+            void link(slot_state *s) override {
+                std::unique_lock<Lockable> _{m_mutex};
+                push(s);
+            }
+
+            void unlink(slot_state *s) noexcept override {
+                std::unique_lock<Lockable> _{m_mutex};
+                remove(s);
+            }
+
+            void disconnect_all() {
+                std::vector<std::shared_ptr<slot_state>> slots;
+                {
+                    std::unique_lock<Lockable> _{m_mutex};
+                    while (slot_state *s = m_head) {
+                        remove(s);
+                        // slots under destruction unlink themselves no more
+                        if (auto p = s->m_self.lock()) {
+                            slots.push_back(std::move(p));
+                        }
+                    }
+                }
+
+                // keep the slots this call disconnects, grouped by signal
+                auto end = std::remove_if(slots.begin(), slots.end(), [](const auto& s) {
+                    return !s->m_connected.exchange(false);
+                });
+                slots.erase(end, slots.end());
+                std::sort(slots.begin(), slots.end(), [](const auto& a, const auto& b) {
+                    return std::less<const cleanable*>{}(a->cleaner(), b->cleaner());
+                });
+
+                std::vector<slot_state*> states;
+                for (auto it = slots.begin(); it != slots.end(); ) {
+                    cleanable *c = (*it)->cleaner();
+                    states.clear();
+                    for (; it != slots.end() && (*it)->cleaner() == c; ++it) {
+                        states.push_back(it->get());
+                    }
+                    if (c) {
+                        c->clean(states.data(), states.size());
+                    }
+                }
+            }
+
+        private:
+            Lockable m_mutex;
+        };
+
+    } // namespace detail
+
+    /**
+     * connection_blocker is a RAII object that blocks a connection until destruction
+     */
+    class connection_blocker {
+    public:
+        connection_blocker() = default;
+        ~connection_blocker() noexcept { release(); }
+
+        connection_blocker(const connection_blocker&) = delete;
+        connection_blocker& operator=(const connection_blocker&) = delete;
+
+        connection_blocker(connection_blocker&& o) noexcept
+        : m_state{std::move(o.m_state)}
+        {}
+
+        connection_blocker& operator=(connection_blocker&& o) noexcept {
+            release();
+            m_state.swap(o.m_state);
+            return *this;
+        }
+
+    private:
+        friend class connection;
+        explicit connection_blocker(std::weak_ptr<detail::slot_state> s) noexcept
+        : m_state{std::move(s)}
+        {
+            if (auto d = m_state.lock()) {
+                d->block();
+            }
+        }
+
+        void release() noexcept {
+            if (auto d = m_state.lock()) {
+                d->unblock();
+            }
+        }
+
+    private:
+        std::weak_ptr<detail::slot_state> m_state;
+    };
+
+
+    /**
+     * A connection object allows interaction with an ongoing slot connection
+     *      * It allows common actions such as connection blocking and disconnection.
+     * Note that connection is not a RAII object, one does not need to hold one
+     * such object to keep the signal-slot connection alive.
+     */
+    class connection {
+    public:
+        connection() = default;
+        virtual ~connection() = default;
+
+        connection(const connection&) noexcept = default;
+        connection& operator=(const connection&) noexcept = default;
+        connection(connection&&) noexcept = default;
+        connection& operator=(connection&&) noexcept = default;
+
+        bool valid() const noexcept {
+            return !m_state.expired();
+        }
+
+        bool connected() const noexcept {
+            const auto d = m_state.lock();
+            return d && d->connected();
+        }
+
+        bool disconnect() noexcept {
+            auto d = m_state.lock();
+            return d && d->disconnect();
+        }
+
+        bool blocked() const noexcept {
+            const auto d = m_state.lock();
+            return d && d->blocked();
+        }
+
+        void block() noexcept {
+            if (auto d = m_state.lock()) {
+                d->block();
+            }
+        }
+
+        void unblock() noexcept {
+            if (auto d = m_state.lock()) {
+                d->unblock();
+            }
+        }
+
+        connection_blocker blocker() const noexcept {
+            return connection_blocker{m_state};
+        }
+
+        uint64_t dropped_emissions() const noexcept {
+            const auto d = m_state.lock();
+            return d ? d->dropped_emissions() : 0;
+        }
+
+        uint64_t blocked_emissions() const noexcept {
+            const auto d = m_state.lock();
+            return d ? d->blocked_emissions() : 0;
+        }
+
+    protected:
+        template <typename, typename...> friend class signal_base;
+        explicit connection(std::weak_ptr<detail::slot_state> s) noexcept
+        : m_state{std::move(s)}
+        {}
+
+    protected:
+        std::weak_ptr<detail::slot_state> m_state;
+    };
+
+    /**
+     * scoped_connection is a RAII version of connection
+     * It disconnects the slot from the signal upon destruction.
+     */
+    class scoped_connection final : public connection {
+    public:
+        scoped_connection() = default;
+        ~scoped_connection() override {
+            disconnect();
+        }
+
+        /*implicit*/ scoped_connection(const connection& c) noexcept : connection(c) {}
+        /*implicit*/ scoped_connection(connection&& c) noexcept : connection(std::move(c)) {}
+
+        scoped_connection(const scoped_connection&) noexcept = delete;
+        scoped_connection& operator=(const scoped_connection&) noexcept = delete;
+
+        scoped_connection(scoped_connection&& o) noexcept
+        : connection{std::move(o.m_state)}
+        {}
+
+        scoped_connection& operator=(scoped_connection&& o) noexcept {
+            disconnect();
+            m_state.swap(o.m_state);
+            return *this;
+        }
+
+    private:
+        template <typename, typename...> friend class signal_base;
+        explicit scoped_connection(std::weak_ptr<detail::slot_state> s) noexcept
+        : connection{std::move(s)}
+        {}
+    };
+
+    /**
+     * Observer is a base class for intrusive lifetime tracking of objects.
+     *      * This is an alternative to trackable pointers, such as std::shared_ptr,
+     * and manual connection management by keeping connection objects in scope.
+     * Deriving from this class allows automatic disconnection of all the slots
+     * connected to any signal when an instance is destroyed.
+     */
+    template <typename Lockable>
+    struct observer_base : private detail::observer_type {
+        observer_base() = default;
+        observer_base(const observer_base&) = delete;
+        observer_base& operator=(const observer_base&) = delete;
+
+        virtual ~observer_base() {
+            if (auto *l = m_links.load(std::memory_order_acquire)) {
+                l->disconnect_all();
+                l->release();
+            }
+        }
+
+    protected:
+        /**
+         * Disconnect all signals connected to this object.
+         *          * To avoid invocation of slots on a semi-destructed instance, which may happen
+         * in multi-threaded contexts, derived classes should call this method in their
+         * destructor. This will ensure proper disconnection prior to the destruction.
+         */
+        void disconnect_all() {
+            if (auto *l = m_links.load(std::memory_order_acquire)) {
+                l->disconnect_all();
+            }
+        }
+
+    private:
+        template <typename, typename ...>
+        friend class signal_base;
+
+        using links_type = detail::observer_list<Lockable>;
+
+        // the list of the connected slots, created on first use
+        links_type& links() {
+            auto *l = m_links.load(std::memory_order_acquire);
+            if (!l) {
+                std::unique_ptr<links_type> n(new links_type);
+                if (m_links.compare_exchange_strong(l, n.get(), std::memory_order_acq_rel)) {
+                    l = n.release();
+                }
+            }
+            return *l;
+        }
+
+        std::atomic<links_type*> m_links{nullptr};
+    };
+
+    /**
+     * Specialization of observer_base to be used in single threaded contexts.
+     */
+    using observer_st = observer_base<detail::null_mutex>;
+
+    /**
+     * Specialization of observer_base to be used in multi-threaded contexts.
+     */
+    using observer = observer_base<std::mutex>;
+
+
+    namespace detail {
+
+        template <typename...>
+        class slot_base;
+
+        /**
+         * Calls f with the arguments of an emission. The last consumer of the
+         * arguments gets them as rvalues, so that arguments taken by value are moved
+         * into it rather than copied, the others get lvalues. Which of the two the
+         * callable accepts is decided at compile time: one only accepting rvalues,
+         * such as a slot taking a move-only type by value, can only be the last
+         * consumer.
+         */
+        template <typename... Args, typename F>
+        void deliver(F&& f, bool last, Args& ...args) {
+            constexpr bool by_lvalue = std::is_invocable<F, Args&...>::value;
+            constexpr bool by_rvalue = std::is_invocable<F, Args&&...>::value;
+            if constexpr (by_lvalue && by_rvalue) {
+                if (last) {
+                    f(static_cast<Args&&>(args)...);
+                } else {
+                    f(args...);
+                }
+            } else if constexpr (by_rvalue) {
+                if (last) {
+                    f(static_cast<Args&&>(args)...);
+                } else {
+                    std::cerr << "move-only arguments can only be consumed by a single slot" << std::endl;
+                }
+            } else {
+                f(args...);
+            }
+        }
+
+        template <typename... T>
+        using slot_ptr = std::shared_ptr<slot_base<T...>>;
+
+        template <typename...>
+        class slot_entry;
+
+        template <typename...>
+        class emission;
+
+
+        /* A base class for slot objects. This base type only depends on slot argument
+         * types, it will be used as an element in an intrusive singly-linked list of
+         * slots, hence the public next member.
+         *
+         * It implements the dispatch of an emission according to the connection type,
+         * derived slots only provide the actual invocation of their callable.
+         */
+        template <typename... Args>
+        class slot_base : public slot_state, public std::enable_shared_from_this<slot_base<Args...>> {
+        public:
+            using base_types = trait::typelist<Args...>;
+
+            explicit slot_base(cleanable& c, uint32_t type, core::TaskQueue* queue, group_id gid)
+            : slot_state(gid)
+            , m_cleaner(c)
+            , m_queue(queue) {
+                m_singleshot = type & connection_type::singleshot_connection;
+                if (type & connection_type::high_priority_connection) {
+                    m_priority = core::TaskPriority::kHigh;
+                } else if (type & connection_type::low_priority_connection) {
+                    m_priority = core::TaskPriority::kLow;
+                }
+                uint32_t t = type;
+                t &= ~connection_type::unique_connection;
+                t &= ~connection_type::singleshot_connection;
+                t &= ~connection_type::high_priority_connection;
+                t &= ~connection_type::low_priority_connection;
+                const uint32_t param = t >> connection_param_shift;
+                const uint32_t policy = (t >> connection_policy_shift) & 3;
+                t &= (uint32_t{1} << connection_policy_shift) - 1;
+                m_type = t;
+                if (has_backlog(t)) {
+                    m_backlog.reset(new backlog);
+                    if (t == connection_type::bounded_connection) {
+                        m_backlog->capacity = std::max<std::size_t>(param, 1);
+                        m_backlog->policy = static_cast<overflow_policy>(policy);
+                    } else {
+                        m_backlog->interval_us = int64_t{param} * 1000;
+                        m_backlog->debounce = t == connection_type::debounced_connection;
+                    }
+                }
+            }
+
+            ~slot_base() override = default;
+
+            // whether arguments u... can be passed by value, which copies lvalues
+            // and moves rvalues
+            template <typename... U>
+            static constexpr bool is_passable_v = (std::is_constructible<Args, U&&>::value && ...);
+
+            // method effectively responsible for calling the "slot" function with
+            // supplied arguments whenever emission happens. Queued calls are added
+            // to the emission, which materializes the arguments once for all of its
+            // queued slots and posts them in batches.
+            template <typename... U>
+            void call_slot(emission<Args...>& e, U&& ...u) {
+                if (!alive()) {
+                    slot_state::disconnect();
+                    return;
+                }
+                if (!this->can_emit()) {
+                    return;
+                }
+                this->set_emitted();
+                uint32_t type = this->type();
+                if (type == connection_type::queued_connection) {
+                    assert(this->m_queue);
+                    if (this->m_queue) {
+                        e.queue(*this);
+                    } else {
+                        std::cerr << "thread is nullptr" << std::endl;
+                    }
+                    return;
+                }
+                if (has_backlog(type)) {
+                    assert(this->m_queue);
+                    if constexpr (is_passable_v<U...>) {
+                        enqueue(e, std::forward<U>(u)...);
+                    } else {
+                        std::cerr << "move-only arguments must be emitted as rvalues to be queued" << std::endl;
+                    }
+                    return;
+                }
+                e.flush();
+                if (type == connection_type::blocking_queued_connection && e.parallel_blocking()) {
+                    fork_blocking(e, u...);
+                    return;
+                }
+                // slots called on this thread run after the blocking ones before them
+                e.join();
+                if (type == connection_type::direct_connection) {
+                    if constexpr (is_passable_v<U...>) {
+                        call_direct(std::forward<U>(u)...);
+                    } else {
+                        run(false, u...);
+                    }
+                } else if (type == connection_type::blocking_queued_connection) {
+                    if constexpr (is_passable_v<U...>) {
+                        call_blocking(std::forward<U>(u)...);
+                    } else {
+                        block_on(false, u...);
+                    }
+                } else {
+                    std::cerr << "illegal connection type" << std::endl;
+                }
+            }
+
+            template <typename... U>
+            void operator()(emission<Args...>& e, U&& ...u) {
+                if (slot_state::connected() && !slot_state::blocked()) {
+                    call_slot(e, std::forward<U>(u)...);
+                }
+            }
+
+            // check if we are storing callable c
+            template <typename C>
+            bool has_callable(const C& c) const {
+                auto p = get_callable();
+                return eq_function_ptr(c, p);
+            }
+
+            template <typename C>
+            std::enable_if_t<function_traits<C>::must_check_object, bool>
+            has_full_callable(const C& c) const {
+                return has_callable(c) && check_class_type<std::decay_t<C>>();
+            }
+
+            template <typename C>
+            std::enable_if_t<!function_traits<C>::must_check_object, bool>
+            has_full_callable(const C& c) const {
+                return has_callable(c);
+            }
+
+            // check if we are storing object o
+            template <typename O>
+            bool has_object(const O& o) const {
+                return get_object() == get_object_ptr(o);
+            }
+
+            void set_unique(bool unique) {
+                this->m_unique = unique;
+            }
+
+            // give the slot a chance to store an inline copy of its callable in
+            // the slot table entry, to be invoked without indirection
+            virtual void bind(slot_entry<Args...>& /*e*/) const {}
+
+            bool is_unique() {
+                return this->m_unique;
+            }
+
+            uint64_t dropped_emissions() const noexcept override {
+                return m_backlog ? m_backlog->dropped.load(std::memory_order_relaxed) : 0;
+            }
+
+            uint64_t blocked_emissions() const noexcept override {
+                return m_backlog ? m_backlog->blocked.load(std::memory_order_relaxed) : 0;
+            }
+
+        protected:
+            cleanable* cleaner() const noexcept final {
+                return &m_cleaner;
+            }
+
+            void do_disconnect() final {
+                m_cleaner.clean(this);
+            }
+
+            // invoke the callable with the supplied arguments on the calling thread,
+            // `last` telling whether it may consume them, see deliver()
+            virtual void invoke(bool last, Args& ...args) = 0;
+
+            // whether the lifetime of the objects the slot depends on allows it to
+            // be called, a slot that is not alive anymore gets disconnected
+            virtual bool alive() const noexcept {
+                return true;
+            }
+
+            // retieve a pointer to the object embedded in the slot
+            virtual obj_ptr get_object() const noexcept {
+                return nullptr;
+            }
+
+            // retieve a pointer to the callable embedded in the slot
+            virtual func_ptr get_callable() const noexcept {
+                return get_function_ptr(nullptr);
+            }
+
+            inline bool can_emit() {
+                if (this->m_singleshot && this->m_emitted) {
+                    return false;
+                }
+                return true;
+            }
+
+            inline void set_emitted() {
+                if (this->m_singleshot && !this->m_emitted) {
+                    this->m_emitted = true;
+                }
+            }
+
+            inline bool is_current() {
+                assert(this->m_queue);
+                auto is_current = false;
+                if (this->m_queue->IsCurrent()) {
+                    is_current = true;
+                }
+                return is_current;
+            }
+
+            uint32_t type() {
+                uint32_t type = this->m_type;
+                if (type == connection_type::auto_connection) {
+                    if (is_current()) {
+                        type = connection_type::direct_connection;
+                    } else {
+                        type = connection_type::queued_connection;
+                    }
+                }
+                return type;
+            }
+
+            // slots called on the emitting thread get their own copy of the
+            // arguments passed by value, which they may consume
+            void call_direct(Args ...args) {
+                run(true, args...);
+            }
+
+            void call_blocking(Args ...args) {
+                block_on(true, args...);
+            }
+
+            void block_on(bool last, Args& ...args) {
+                latch done;
+                post_blocking(done, last, args...);
+                done.wait();
+            }
+
+            // post a blocking call referring to args, which must stay valid until
+            // `done` has been waited for
+            void post_blocking(latch& done, bool last, Args& ...args) {
+                assert(this->m_queue);
+                blocking_call *call = m_blocking_pool.acquire();
+                if (!call) {
+                    call = new blocking_call(*this);
+                }
+                call->m_done = &done;
+                call->m_last = last;
+                call->m_args.emplace(args...);
+                done.add();
+                this->m_queue->PostTask(std::unique_ptr<core::QueuedTask>(call), m_priority);
+            }
+
+            // post a blocking call the emission waits for along with the others,
+            // see signal_base::set_parallel_blocking(). The calls run concurrently
+            // and only read the arguments, which are those of the emitter if
+            // they can be referred to as they are, or the arguments block of the
+            // emission otherwise. A source that may be moved from is always
+            // moved into the block first, so that no later slot moves it away
+            // from under the calls.
+            template <typename... U>
+            void fork_blocking(emission<Args...>& e, U& ...u) {
+                if constexpr ((std::is_convertible<U&, Args&>::value && ...)) {
+                    if (!e.moves()) {
+                        post_blocking(e.blocking_latch(), false, u...);
+                        return;
+                    }
+                }
+                shared_args<Args...> *block = e.materialize();
+                if (!block) {
+                    return;
+                }
+                std::apply([&](auto& ...a) { post_blocking(e.blocking_latch(), false, a...); }, block->args());
+            }
+
+            // whether slots of that type keep their own queue of pending calls
+            static constexpr bool has_backlog(uint32_t type) {
+                return type == connection_type::coalesced_connection ||
+                       type == connection_type::throttled_connection ||
+                       type == connection_type::debounced_connection ||
+                       type == connection_type::bounded_connection;
+            }
+
+            // add the arguments to the backlog of the slot, applying its overflow
+            // policy if it is full, and post a call to drain it unless one is
+            // pending already. Coalesced slots hold a single pending call, which
+            // later emissions overwrite.
+            template <typename... U>
+            void enqueue(emission<Args...>& e, U&& ...u) {
+                backlog &b = *m_backlog;
+                std::unique_lock<std::mutex> lock(b.mutex);
+                const int64_t now_us = b.interval_us ? core::TimeMicros() : 0;
+                if (b.debounce) {
+                    b.last_us = now_us;
+                }
+                if (b.pending.size() >= b.capacity) {
+                    switch (b.policy) {
+                    case overflow_policy::drop_oldest:
+                        ++b.dropped;
+                        if (b.pending.size() > 1) {
+                            b.pending.push_back(std::move(b.pending.front()));
+                            b.pending.pop_front();
+                        }
+                        if constexpr ((std::is_assignable<std::decay_t<Args>&, U&&>::value && ...)) {
+                            // element-wise, so that the stored values may reuse
+                            // their resources
+                            b.pending.back() = std::forward_as_tuple(std::forward<U>(u)...);
+                        } else {
+                            b.pending.pop_back();
+                            b.pending.emplace_back(std::forward<U>(u)...);
+                        }
+                        return;
+                    case overflow_policy::block_emitter:
+                        if (!is_current()) {
+                            ++b.blocked;
+                            b.room.wait(lock, [&] { return b.pending.size() < b.capacity; });
+                            break;
+                        }
+                        // waiting for the queue we are running on would deadlock
+                        ++b.dropped;
+                        return;
+                    case overflow_policy::call_directly:
+                        ++b.blocked;
+                        lock.unlock();
+                        // run after the queued and blocking slots before it,
+                        // as any slot called on this thread
+                        e.flush();
+                        e.join();
+                        call_direct(std::forward<U>(u)...);
+                        return;
+                    default:
+                        ++b.dropped;
+                        return;
+                    }
+                }
+                b.pending.emplace_back(std::forward<U>(u)...);
+                if (b.posted) {
+                    return;
+                }
+                b.posted = true;
+                // a throttled slot that ran recently waits for the rest of its
+                // interval
+                const int64_t delay_us = b.debounce ? b.interval_us : b.last_us + b.interval_us - now_us;
+                lock.unlock();
+
+                drain_call *call = b.pool.acquire();
+                if (!call) {
+                    call = new drain_call(this->weak_from_this());
+                }
+                call->m_posted = true;
+                // keep the order of the batches of this emission queued so far
+                e.flush();
+                if (delay_us > 0) {
+                    this->m_queue->PostDelayedTask(std::unique_ptr<core::QueuedTask>(call),
+                                                   core::TimeDelta::Micros(delay_us));
+                } else {
+                    this->m_queue->PostTask(std::unique_ptr<core::QueuedTask>(call), m_priority);
+                }
+            }
+
+            // run the slot on the current thread, whatever the connection type
+            void run(bool last, Args& ...args) {
+                if (this->slot_state::connected()) {
+                    invoke(last, args...);
+                    if (this->m_singleshot && this->m_emitted) {
+                        this->slot_state::disconnect();
+                    }
+                } else {
+                    std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
+                }
+            }
+
+#ifdef SIGSLOT_RTTI_ENABLED
+            // retieve a pointer to the callable embedded in the slot
+            virtual const std::type_info& get_callable_type() const noexcept {
+                return typeid(nullptr);
+            }
+
+        private:
+            template <typename U>
+            bool check_class_type() const {
+                return typeid(U) == get_callable_type();
+            }
+
+#else
+            template <typename U>
+            bool check_class_type() const {
+                return false;
+            }
+#endif
+
+        private:
+            friend class emission<Args...>;
+
+            /*
+             * A task posted for the queued slots of one emission that target the
+             * same task queue with the same priority. It refers to the arguments block of the emission and
+             * holds weak references to the slots, which may be gone by the time the
+             * task runs, and runs them in the order they were added. Once run, the
+             * task goes back to a pool shared by all the signals of the same
+             * arguments, so that steady state queued emissions do not allocate.
+             */
+            class batched_call final : public core::QueuedTask {
+            private:
+                friend class emission<Args...>;
+                friend class call_pool<batched_call>;
+
+                // slots a new task has room for, pooled tasks are reused for
+                // batches of any size and keep their capacity
+                static constexpr std::size_t reserved_slots = 4;
+
+                // leaked on purpose, tasks may still be dropped by task queues
+                // during static destruction
+                static call_pool<batched_call>& pool() {
+                    static auto *p = new call_pool<batched_call>;
+                    return *p;
+                }
+
+                batched_call() {
+                    m_slots.reserve(reserved_slots);
+                }
+
+                ~batched_call() override {
+                    // dropped by a queue being deleted
+                    if (m_args) {
+                        m_args->release();
+                    }
+                }
+
+                bool run() override {
+                    const std::size_t n = m_slots.size();
+                    for (std::size_t i = 0; i < n; ++i) {
+                        if (auto self = m_slots[i].lock()) {
+                            // the last slot of the last batch to run may consume the
+                            // arguments
+                            const bool last = i + 1 == n && m_args->unique();
+                            std::apply([&](auto& ...a) { self->run(last, a...); }, m_args->args());
+                        }
+                    }
+                    m_slots.clear();
+                    std::exchange(m_args, nullptr)->release();
+                    return !pool().release(this);
+                }
+
+                std::vector<std::weak_ptr<slot_base>> m_slots;
+                shared_args<Args...> *m_args = nullptr;
+                batched_call *m_next = nullptr;
+            };
+
+            /*
+             * A task posted for a blocking queued emission. It refers to the arguments
+             * of the emitting thread, which waits on a latch until the task has run or
+             * has been dropped by the queue. The task is pooled by its slot, which the
+             * waiting emitter keeps alive, so the rendezvous does not allocate either.
+             */
+            class blocking_call final : public core::QueuedTask {
+            public:
+                explicit blocking_call(slot_base& slot)
+                : m_slot(slot)
+                {}
+
+                ~blocking_call() override {
+                    // dropped by a queue being deleted, release the emitter
+                    if (m_done) {
+                        m_done->arrive();
+                    }
+                }
+
+            private:
+                friend class slot_base;
+                friend class call_pool<blocking_call>;
+
+                bool run() override {
+                    std::apply([&](auto& ...a) { m_slot.run(m_last, a...); }, *m_args);
+                    m_args.reset();
+                    // the emitter may return and the slot go away as soon as the
+                    // latch is released, so the call must not be touched afterwards
+                    latch *done = std::exchange(m_done, nullptr);
+                    bool pooled = m_slot.m_blocking_pool.release(this);
+                    done->arrive();
+                    return !pooled;
+                }
+
+                slot_base& m_slot;
+                latch *m_done = nullptr;
+                bool m_last = false;
+                std::optional<std::tuple<Args&...>> m_args;
+                blocking_call *m_next = nullptr;
+            };
+
+            /*
+             * The call posted to drain the backlog of a slot. It takes the
+             * arguments of the backlog when it runs rather than when it is posted,
+             * so emissions made meanwhile only add to the backlog, and a single
+             * call is pending or running at a time. Past a few slot calls it posts
+             * itself again, not to hold the queue for too long. Calls are pooled
+             * by their slot, which they only refer to weakly.
+             * A throttled or debounced call that is not due yet, when posted or
+             * after running the slot, posts itself again delayed by the rest of
+             * the interval, so a burst costs one timer per interval rather than
+             * one per emission.
+             */
+            class drain_call final : public core::QueuedTask {
+            public:
+                explicit drain_call(std::weak_ptr<slot_base> slot)
+                : m_slot(std::move(slot))
+                {}
+
+                ~drain_call() override {
+                    // dropped by a queue being deleted, release blocked emitters
+                    if (m_posted) {
+                        if (auto self = m_slot.lock()) {
+                            backlog &b = *self->m_backlog;
+                            std::lock_guard<std::mutex> lock(b.mutex);
+                            b.pending.clear();
+                            b.posted = false;
+                            b.room.notify_all();
+                        }
+                    }
+                }
+
+            private:
+                friend class slot_base;
+                friend class call_pool<drain_call>;
+
+                // slot calls made by a call before it posts itself again
+                static constexpr int max_calls_per_run = 32;
+
+                bool run() override {
+                    auto self = m_slot.lock();
+                    if (!self) {
+                        m_posted = false;
+                        return true;
+                    }
+                    backlog &b = *self->m_backlog;
+                    // the backlog stays posted until the call lets go of it, so
+                    // emissions made while the slot runs do not post another call
+                    for (int i = 0; i < max_calls_per_run; ++i) {
+                        int64_t delay_us = 0;
+                        {
+                            std::lock_guard<std::mutex> lock(b.mutex);
+                            if (b.pending.empty()) {
+                                b.posted = false;
+                                m_posted = false;
+                                return !b.pool.release(this);
+                            }
+                            const int64_t now_us = b.interval_us ? core::TimeMicros() : 0;
+                            if (b.interval_us) {
+                                // an interval since the latest emission if
+                                // debounced, since the latest call if throttled
+                                delay_us = b.last_us + b.interval_us - now_us;
+                            }
+                            if (delay_us <= 0) {
+                                m_args.emplace(std::move(b.pending.front()));
+                                b.pending.pop_front();
+                                if (b.interval_us && !b.debounce) {
+                                    b.last_us = now_us;
+                                }
+                                if (b.policy == overflow_policy::block_emitter) {
+                                    b.room.notify_all();
+                                }
+                            }
+                        }
+                        if (delay_us > 0) {
+                            self->m_queue->PostDelayedTask(std::unique_ptr<core::QueuedTask>(this),
+                                                           core::TimeDelta::Micros(delay_us));
+                            return false;
+                        }
+                        std::apply([&](auto& ...a) { self->run(true, a...); }, *m_args);
+                        m_args.reset();
+                    }
+                    // no interval left to wait for, but let other tasks run
+                    self->m_queue->PostTask(std::unique_ptr<core::QueuedTask>(this), self->m_priority);
+                    return false;
+                }
+
+                std::weak_ptr<slot_base> m_slot;
+                std::optional<std::tuple<std::decay_t<Args>...>> m_args;
+                bool m_posted = false;
+                drain_call *m_next = nullptr;
+            };
+
+            // the pending calls of coalesced, throttled, debounced and bounded
+            // slots, only allocated for those
+            struct backlog {
+                std::mutex mutex;
+                // arguments of the pending calls, oldest first
+                std::deque<std::tuple<std::decay_t<Args>...>> pending;
+                // whether a call is posted to drain them
+                bool posted = false;
+                std::size_t capacity = 1;
+                overflow_policy policy = overflow_policy::drop_oldest;
+                // signaled as calls are taken if emitters block
+                std::condition_variable room;
+                std::atomic<uint64_t> dropped = {0};
+                std::atomic<uint64_t> blocked = {0};
+                int64_t interval_us = 0;
+                bool debounce = false;
+                // time of the latest emission if debounced, of the latest call
+                // otherwise, far enough in the past for a first call not to wait
+                int64_t last_us = std::numeric_limits<int64_t>::min() / 2;
+                call_pool<drain_call> pool;
+            };
+
+        protected:
+            std::atomic<uint32_t> m_type = {0};
+            std::atomic_bool m_unique = {false};
+            core::TaskQueue* m_queue = nullptr;
+            core::TaskPriority m_priority = core::TaskPriority::kNormal;
+            std::atomic_bool m_singleshot = {false};
+            std::atomic_bool m_emitted = {false};
+
+        private:
+            cleanable& m_cleaner;
+            call_pool<blocking_call> m_blocking_pool;
+            std::unique_ptr<backlog> m_backlog;
+        };
+
+        /*
+         * An element of the flat slot table of a signal.
+         *
+         * It owns a slot, and may additionally hold an inline copy of small callables
+         * with a direct function pointer thunk to invoke them. Emission through such
+         * an entry neither chases the slot pointer to reach the callable nor goes
+         * through call_slot(). Only direct connections of trivially copyable
+         * callables that can be invoked as const are stored inline, so that the
+         * copy is indistinguishable from the callable owned by the slot.
+         */
+        template <typename... Args>
+        class slot_entry {
+            using invoker = void (*)(const slot_entry&, Args...);
+
+        public:
+            static constexpr std::size_t inline_size = 3 * sizeof(void*);
+
+            template <typename F>
+            static constexpr bool is_inlinable_v = std::is_trivially_copyable<F>::value &&
+                                                   sizeof(F) <= inline_size &&
+                                                   alignof(F) <= alignof(void*) &&
+                                                   trait::is_callable_v<trait::typelist<Args...>, const F&>;
 
-            // method effectively responsible for calling the "slot" function with
-            // supplied arguments whenever emission happens.
-            virtual void call_slot(Args...) = 0;
+            explicit slot_entry(slot_ptr<Args...> s)
+            : m_slot(std::move(s))
+            {
+                m_slot->bind(*this);
+            }
 
             template <typename... U>
-            void operator()(U&& ...u) {
-                if (slot_state::connected() && !slot_state::blocked()) {
-                    call_slot(std::forward<U>(u)...);
+            void operator()(emission<Args...>& e, U&& ...u) const {
+                if constexpr ((std::is_constructible<Args, U&&>::value && ...)) {
+                    if (m_invoke) {
+                        e.flush();
+                        e.join();
+                        m_invoke(*this, std::forward<U>(u)...);
+                        return;
+                    }
                 }
+                m_slot->operator()(e, std::forward<U>(u)...);
             }
 
-            // check if we are storing callable c
-            template <typename C>
-            bool has_callable(const C& c) const {
-                auto p = get_callable();
-                return eq_function_ptr(c, p);
+            template <typename F>
+            void store(const F& f) {
+                static_assert(is_inlinable_v<F>, "callable can not be stored inline");
+                new (m_storage) F(f);
+                m_invoke = &invoke_inline<F>;
             }
 
-            template <typename C>
-            std::enable_if_t<function_traits<C>::must_check_object, bool>
-            has_full_callable(const C& c) const {
-                return has_callable(c) && check_class_type<std::decay_t<C>>();
+            slot_base<Args...>* operator->() const noexcept {
+                return m_slot.get();
             }
 
-            template <typename C>
-            std::enable_if_t<!function_traits<C>::must_check_object, bool>
-            has_full_callable(const C& c) const {
-                return has_callable(c);
+            slot_base<Args...>* get() const noexcept {
+                return m_slot.get();
             }
 
-            // check if we are storing object o
-            template <typename O>
-            bool has_object(const O& o) const {
-                return get_object() == get_object_ptr(o);
+            const slot_ptr<Args...>& ptr() const noexcept {
+                return m_slot;
             }
 
-            void set_unique(bool unique) {
-                this->m_unique = unique;
+            explicit operator bool() const noexcept {
+                return static_cast<bool>(m_slot);
             }
 
-            bool is_unique() {
-                return this->m_unique;
+        private:
+            template <typename F>
+            static void invoke_inline(const slot_entry& e, Args ...args) {
+                const auto *s = e.m_slot.get();
+                if (s->slot_state::connected() && !s->blocked()) {
+                    // the arguments are the copies owned by this call
+                    (*reinterpret_cast<const F*>(e.m_storage))(static_cast<Args&&>(args)...);
+                }
             }
 
-        protected:
-            void do_disconnect() final {
-                m_cleaner.clean(this);
+        private:
+            slot_ptr<Args...> m_slot;
+            invoker m_invoke = nullptr;
+            alignas(void*) unsigned char m_storage[inline_size];
+        };
+
+        /*
+         * The state of one signal emission: the queued calls it produced, grouped
+         * by destination task queue so that each queue gets a single task for all
+         * of its slots rather than one per slot.
+         *
+         * The arguments are materialized once, on the first queued call, into a
+         * block that all the batches share: rvalue arguments are moved into it, the
+         * others copied. Once rvalues have been moved, the slots running on the
+         * emitting thread read the arguments from the block as well.
+         *
+         * Batches are posted when the emission ends, and before any slot runs on
+         * the emitting thread, so that queued slots run in the same order relative
+         * to direct and blocking slots as if they had been posted one by one.
+         */
+        template <typename... Args>
+        class emission {
+            using batched_call = typename slot_base<Args...>::batched_call;
+            using args_maker = shared_args<Args...>* (*)(void *source);
+
+            struct batch {
+                core::TaskQueue *queue;
+                core::TaskPriority priority;
+                batched_call *call;
+            };
+
+        public:
+            // number of destination queues tracked without allocating
+            static constexpr std::size_t inline_batches = 4;
+
+            // `source` holds references to the arguments as passed to the signal,
+            // see std::forward_as_tuple, it must outlive the emission
+            template <typename... R>
+            explicit emission(std::tuple<R...>& source, bool parallel_blocking = false)
+            : m_source(&source)
+            , m_make(&make_args<R...>)
+            , m_moves((std::is_rvalue_reference<R>::value || ...))
+            , m_parallel_blocking(parallel_blocking)
+            {}
+
+            emission(const emission&) = delete;
+            emission& operator=(const emission&) = delete;
+
+            ~emission() {
+                // blocking calls may refer to the arguments block
+                join();
+                // let go of the arguments first, so that the last batch to run
+                // knows it may consume them
+                if (m_args) {
+                    m_args->release();
+                }
+                flush();
             }
 
-            // retieve a pointer to the object embedded in the slot
-            virtual obj_ptr get_object() const noexcept {
-                return nullptr;
+            // whether the source arguments may be moved from
+            bool moves() const noexcept {
+                return m_moves;
             }
 
-            // retieve a pointer to the callable embedded in the slot
-            virtual func_ptr get_callable() const noexcept {
-                return get_function_ptr(nullptr);
+            // whether the source arguments have been moved into the block
+            bool moved() const noexcept {
+                return m_moves && m_args;
             }
 
-            inline bool can_emit() {
-                if (this->m_singleshot && this->m_emitted) {
-                    return false;
+            typename shared_args<Args...>::tuple_type& args() noexcept {
+                return m_args->args();
+            }
+
+            // the arguments block, made from the source arguments on first use,
+            // nullptr if they can not be copied
+            shared_args<Args...>* materialize() {
+                if (!m_args) {
+                    m_args = m_make(m_source);
+                    if (!m_args) {
+                        std::cerr << "move-only arguments must be emitted as rvalues to be queued" << std::endl;
+                    }
                 }
-                return true;
+                return m_args;
             }
 
-            inline void set_emitted() {
-                if (this->m_singleshot && !this->m_emitted) {
-                    this->m_emitted = true;
+            // add a queued call of slot s to the batch of its queue
+            void queue(slot_base<Args...>& s) {
+                batched_call *call = find(s.m_queue, s.m_priority);
+                if (!call) {
+                    if (!materialize()) {
+                        return;
+                    }
+                    call = batched_call::pool().acquire();
+                    if (!call) {
+                        call = new batched_call;
+                    }
+                    m_args->add_ref();
+                    call->m_args = m_args;
+                    add({s.m_queue, s.m_priority, call});
                 }
+                call->m_slots.push_back(s.weak_from_this());
             }
 
-            inline bool is_current() {
-                assert(this->m_queue);
-                auto is_current = false;
-                if (this->m_queue->IsCurrent()) {
-                    is_current = true;
+            // post the pending batches
+            void flush() {
+                if (m_size == 0) {
+                    return;
                 }
-                return is_current;
+                for (std::size_t i = 0; i < m_size; ++i) {
+                    batch &b = at(i);
+                    b.queue->PostTask(std::unique_ptr<core::QueuedTask>(b.call), b.priority);
+                }
+                m_size = 0;
+                m_overflow.clear();
             }
 
-            uint32_t type() {
-                uint32_t type = this->m_type;
-                if (type == connection_type::auto_connection) {
-                    if (is_current()) {
-                        type = connection_type::direct_connection;
-                    } else {
-                        type = connection_type::queued_connection;
-                    }
+            // whether blocking slots are posted all at once then waited for
+            bool parallel_blocking() const noexcept {
+                return m_parallel_blocking;
+            }
+
+            // the latch of the pending parallel blocking calls
+            latch& blocking_latch() {
+                if (!m_latch) {
+                    m_latch.emplace();
                 }
-                return type;
+                m_joining = true;
+                return *m_latch;
             }
 
-#ifdef SIGSLOT_RTTI_ENABLED
-            // retieve a pointer to the callable embedded in the slot
-            virtual const std::type_info& get_callable_type() const noexcept {
-                return typeid(nullptr);
+            // wait for the pending parallel blocking calls
+            void join() {
+                if (m_joining) {
+                    m_joining = false;
+                    m_latch->wait();
+                }
             }
 
         private:
-            template <typename U>
-            bool check_class_type() const {
-                return typeid(U) == get_callable_type();
+            // moves or copies the source arguments into a new block, returns
+            // nullptr if they can not be copied
+            template <typename... R>
+            static shared_args<Args...>* make_args(void *source) {
+                if constexpr ((std::is_constructible<std::decay_t<Args>, R>::value && ...)) {
+                    return std::apply([](auto&& ...u) {
+                        return shared_args<Args...>::make(std::forward<decltype(u)>(u)...);
+                    }, std::move(*static_cast<std::tuple<R...>*>(source)));
+                } else {
+                    return nullptr;
+                }
             }
 
-#else
-            template <typename U>
-            bool check_class_type() const {
-                return false;
+            batch& at(std::size_t i) {
+                return i < inline_batches ? m_inline[i] : m_overflow[i - inline_batches];
             }
-#endif
-        protected:
-            std::atomic<uint32_t> m_type = {0};
-            std::atomic_bool m_unique = {false};
-            core::TaskQueue* m_queue = nullptr;
-            std::atomic_bool m_singleshot = {false};
-            std::atomic_bool m_emitted = {false};
 
-        private:
-            cleanable& m_cleaner;
+            batched_call* find(core::TaskQueue *queue, core::TaskPriority priority) {
+                for (std::size_t i = 0; i < m_size; ++i) {
+                    if (at(i).queue == queue && at(i).priority == priority) {
+                        return at(i).call;
+                    }
+                }
+                return nullptr;
+            }
+
+            void add(batch b) {
+                if (m_size < inline_batches) {
+                    m_inline[m_size] = b;
+                } else {
+                    m_overflow.push_back(b);
+                }
+                ++m_size;
+            }
+
+            batch m_inline[inline_batches];
+            std::vector<batch> m_overflow;
+            std::size_t m_size = 0;
+            void *m_source;
+            args_maker m_make;
+            const bool m_moves;
+            shared_args<Args...> *m_args = nullptr;
+            const bool m_parallel_blocking;
+            // made on first use, events are not free on every platform
+            std::optional<latch> m_latch;
+            bool m_joining = false;
         };
 
         /*
@@ -950,70 +2688,26 @@ namespace sigslot {
          * whenever the function call operator of its slot_base base class is called.
          */
         template <typename Func, typename... Args>
-        class slot final : public slot_base<Args...>, public std::enable_shared_from_this<slot<Func, Args...>> {
+        class slot final : public slot_base<Args...> {
         public:
-            using this_type = slot<Func, Args...>;
             template <typename F, typename Gid>
             constexpr slot(cleanable& c, F&& f, uint32_t type, core::TaskQueue* queue, Gid gid)
             : slot_base<Args...>(c, type, queue, gid)
             , func{std::forward<F>(f)} {}
 
-        protected:
-            void call_slot(Args ...args) override {
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        func(args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                self->func(args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
+            void bind(slot_entry<Args...>& e) const override {
+                if constexpr (slot_entry<Args...>::template is_inlinable_v<std::decay_t<Func>>) {
+                    if (this->m_type == connection_type::direct_connection && !this->m_singleshot) {
+                        e.store(func);
                     }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            this->func(args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
                 }
             }
 
+        protected:
+            void invoke(bool last, Args& ...args) override {
+                deliver<Args...>(func, last, args...);
+            }
+
             func_ptr get_callable() const noexcept override {
                 return get_function_ptr(func);
             }
@@ -1032,9 +2726,8 @@ namespace sigslot {
          * Variation of slot that prepends a connection object to the callable
          */
         template <typename Func, typename... Args>
-        class slot_extended final : public slot_base<Args...>, public std::enable_shared_from_this<slot_extended<Func, Args...>> {
+        class slot_extended final : public slot_base<Args...> {
         public:
-            using this_type = slot_extended<Func, Args...>;
             template <typename F>
             constexpr slot_extended(cleanable& c, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
             : slot_base<Args...>(c, type, queue, gid)
@@ -1043,59 +2736,11 @@ namespace sigslot {
             connection conn;
 
         protected:
-            void call_slot(Args ...args) override {
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        func(conn, args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                self->func(self->conn, args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            this->func(this->conn, args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
-                }
+            void invoke(bool last, Args& ...args) override {
+                auto f = [this](auto&& ...a) -> decltype(func(conn, std::forward<decltype(a)>(a)...)) {
+                    return func(conn, std::forward<decltype(a)>(a)...);
+                };
+                deliver<Args...>(f, last, args...);
             }
 
             func_ptr get_callable() const noexcept override {
@@ -1118,71 +2763,41 @@ namespace sigslot {
          * base class is called.
          */
         template <typename Ptr, typename Pmf, typename... Args>
-        class slot_pmf final : public slot_base<Args...>, public std::enable_shared_from_this<slot_pmf<Ptr, Pmf, Args...>> {
+        class slot_pmf final : public slot_base<Args...> {
         public:
-            using this_type = slot_pmf<Ptr, Pmf, Args...>;
             template <typename P, typename F>
             constexpr slot_pmf(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
             : slot_base<Args...>(c, type, queue, gid)
             , ptr{std::forward<P>(p)}
             , pmf{std::forward<F>(f)} {}
 
-        protected:
-            void call_slot(Args ...args) override {
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        ((*ptr).*pmf)(args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
+            void bind(slot_entry<Args...>& e) const override {
+                // a naked object pointer and its member function are invoked inline
+                struct bound_pmf {
+                    std::decay_t<Ptr> ptr;
+                    std::decay_t<Pmf> pmf;
+
+                    void operator()(Args ...args) const {
+                        ((*ptr).*pmf)(static_cast<Args&&>(args)...);
                     }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                ((*(self->ptr)).*(self->pmf))(args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
+                };
+
+                if constexpr (std::is_pointer<std::decay_t<Ptr>>::value &&
+                              slot_entry<Args...>::template is_inlinable_v<bound_pmf>) {
+                    if (this->m_type == connection_type::direct_connection && !this->m_singleshot) {
+                        e.store(bound_pmf{ptr, pmf});
                     }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            ((*(this->ptr)).*(this->pmf))(args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
                 }
             }
 
+        protected:
+            void invoke(bool last, Args& ...args) override {
+                auto f = [this](auto&& ...a) -> decltype(((*ptr).*pmf)(std::forward<decltype(a)>(a)...)) {
+                    return ((*ptr).*pmf)(std::forward<decltype(a)>(a)...);
+                };
+                deliver<Args...>(f, last, args...);
+            }
+
             func_ptr get_callable() const noexcept override {
                 return get_function_ptr(pmf);
             }
@@ -1206,9 +2821,8 @@ namespace sigslot {
          * Variation of slot that prepends a connection object to the callable
          */
         template <typename Ptr, typename Pmf, typename... Args>
-        class slot_pmf_extended final : public slot_base<Args...>, public std::enable_shared_from_this<slot_pmf_extended<Ptr, Pmf, Args...>> {
+        class slot_pmf_extended final : public slot_base<Args...> {
         public:
-            using this_type = slot_pmf_extended<Ptr, Pmf, Args...>;
             template <typename P, typename F>
             constexpr slot_pmf_extended(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* executor, group_id gid)
             : slot_base<Args...>(c, type, executor, gid)
@@ -1218,59 +2832,11 @@ namespace sigslot {
             connection conn;
 
         protected:
-            void call_slot(Args ...args) override {
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        ((*ptr).*pmf)(conn, args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                ((*(self->ptr)).*(self->pmf))(self->conn, args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            ((*(this->ptr)).*(this->pmf))(this->conn, args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
-                }
+            void invoke(bool last, Args& ...args) override {
+                auto f = [this](auto&& ...a) -> decltype(((*ptr).*pmf)(conn, std::forward<decltype(a)>(a)...)) {
+                    return ((*ptr).*pmf)(conn, std::forward<decltype(a)>(a)...);
+                };
+                deliver<Args...>(f, last, args...);
             }
 
             func_ptr get_callable() const noexcept override {
@@ -1298,80 +2864,30 @@ namespace sigslot {
          * on said object destruction.
          */
         template <typename WeakPtr, typename Func, typename... Args>
-        class slot_tracked final : public slot_base<Args...>, public std::enable_shared_from_this<slot_tracked<WeakPtr, Func, Args...>> {
+        class slot_tracked final : public slot_base<Args...> {
         public:
-            using this_type = slot_tracked<WeakPtr, Func, Args...>;
             template <typename P, typename F>
-            constexpr slot_tracked(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
-            : slot_base<Args...>(c, type, queue, gid)
-            , ptr{std::forward<P>(p)}
-            , func{std::forward<F>(f)} {}
-
-            bool connected() const noexcept override {
-                return !ptr.expired() && slot_state::connected();
-            }
-
-        protected:
-            void call_slot(Args ...args) override {
-                auto sp = ptr.lock();
-                if (!sp) {
-                    slot_state::disconnect();
-                    return;
-                }
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        func(args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                self->func(args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            this->func(args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
+            constexpr slot_tracked(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
+            : slot_base<Args...>(c, type, queue, gid)
+            , ptr{std::forward<P>(p)}
+            , func{std::forward<F>(f)} {}
+
+            bool connected() const noexcept override {
+                return !ptr.expired() && slot_state::connected();
+            }
+
+        protected:
+            void invoke(bool last, Args& ...args) override {
+                // keep the tracked object alive during the call
+                if (auto sp = ptr.lock()) {
+                    deliver<Args...>(func, last, args...);
                 }
             }
 
+            bool alive() const noexcept override {
+                return !ptr.expired();
+            }
+
             func_ptr get_callable() const noexcept override {
                 return get_function_ptr(func);
             }
@@ -1397,9 +2913,8 @@ namespace sigslot {
          * disconnect the slot on said object destruction.
          */
         template <typename WeakPtr, typename Pmf, typename... Args>
-        class slot_pmf_tracked final : public slot_base<Args...>, public std::enable_shared_from_this<slot_pmf_tracked<WeakPtr, Pmf, Args...>> {
+        class slot_pmf_tracked final : public slot_base<Args...> {
         public:
-            using this_type = slot_pmf_tracked<WeakPtr, Pmf, Args...>;
             template <typename P, typename F>
             constexpr slot_pmf_tracked(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
             : slot_base<Args...>(c, type, queue, gid)
@@ -1411,66 +2926,19 @@ namespace sigslot {
             }
 
         protected:
-            void call_slot(Args ...args) override {
-                auto sp = ptr.lock();
-                if (!sp) {
-                    slot_state::disconnect();
-                    return;
-                }
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        ((*sp).*pmf)(args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), sp, args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                ((*sp).*(self->pmf))(args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, sp, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            (*sp.*(this->pmf))(this->conn, args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
+            void invoke(bool last, Args& ...args) override {
+                if (auto sp = ptr.lock()) {
+                    auto f = [&sp, this](auto&& ...a) -> decltype(((*sp).*pmf)(std::forward<decltype(a)>(a)...)) {
+                        return ((*sp).*pmf)(std::forward<decltype(a)>(a)...);
+                    };
+                    deliver<Args...>(f, last, args...);
                 }
             }
 
+            bool alive() const noexcept override {
+                return !ptr.expired();
+            }
+
             func_ptr get_callable() const noexcept override {
                 return get_function_ptr(pmf);
             }
@@ -1490,6 +2958,104 @@ namespace sigslot {
             std::decay_t<Pmf> pmf;
         };
 
+        /*
+         * The key of a slot in the unique slots index: its callable and, for
+         * member functions, its object. Only the bytes of the callable are
+         * compared, so the candidates found under a key are confirmed by the
+         * caller. Callables that can not be compared have no key.
+         */
+        struct callable_key {
+            func_ptr callable;
+            obj_ptr object;
+
+            explicit operator bool() const noexcept {
+                return !callable.empty();
+            }
+
+            bool operator==(const callable_key& o) const noexcept {
+                return object == o.object && callable == o.callable;
+            }
+
+            struct hash {
+                std::size_t operator()(const callable_key& k) const noexcept {
+                    const std::size_t h = k.callable.hash();
+                    return h ^ (std::hash<obj_ptr>{}(k.object) + 0x9e3779b9 + (h << 6) + (h >> 2));
+                }
+            };
+        };
+
+        /*
+         * A hash index over some of the slots of a signal, letting it find the
+         * slots bound to a callable or an object without going through them
+         * all. Each slot is indexed under the key it had when connected, which
+         * is kept for its removal since tracked slots lose their object on
+         * expiry. Null keys are not indexed. Not thread safe.
+         */
+        template <typename Key, typename Hash, typename... Args>
+        class slot_index {
+        public:
+            bool empty() const noexcept {
+                return m_keys.empty();
+            }
+
+            // whether a slot indexed under key k satisfies cond
+            template <typename Cond>
+            bool contains(const Key& k, Cond&& cond) const {
+                if (m_keys.empty() || !k) {
+                    return false;
+                }
+                const auto range = m_slots.equal_range(k);
+                return std::any_of(range.first, range.second, [&](const auto& v) {
+                    return cond(v.second);
+                });
+            }
+
+            // call f with each slot indexed under key k
+            template <typename F>
+            void for_each(const Key& k, F&& f) const {
+                if (m_keys.empty() || !k) {
+                    return;
+                }
+                const auto range = m_slots.equal_range(k);
+                for (auto it = range.first; it != range.second; ++it) {
+                    f(it->second);
+                }
+            }
+
+            void insert(const Key& k, slot_base<Args...> *s) {
+                if (k && m_keys.emplace(s, k).second) {
+                    m_slots.emplace(k, s);
+                }
+            }
+
+            void erase(const slot_state *s) {
+                if (m_keys.empty()) {
+                    return;
+                }
+                const auto it = m_keys.find(s);
+                if (it == m_keys.end()) {
+                    return;
+                }
+                auto range = m_slots.equal_range(it->second);
+                for (; range.first != range.second; ++range.first) {
+                    if (range.first->second == s) {
+                        m_slots.erase(range.first);
+                        break;
+                    }
+                }
+                m_keys.erase(it);
+            }
+
+            void clear() noexcept {
+                m_slots.clear();
+                m_keys.clear();
+            }
+
+        private:
+            std::unordered_multimap<Key, slot_base<Args...>*, Hash> m_slots;
+            std::unordered_map<const slot_state*, Key> m_keys;
+        };
+
     } // namespace detail
 
 
@@ -1520,22 +3086,39 @@ namespace sigslot {
 
         template <typename U, typename L>
         using cow_copy_type = std::conditional_t<is_thread_safe<L>::value,
-                                                 detail::copy_on_write<U>, const U&>;
+                                                 detail::cow_snapshot<U>, const U&>;
 
         using lock_type = std::unique_lock<Lockable>;
+        struct write_lock {
+            detail::epoch_domain::deferral reclaim;
+            lock_type lock;
+        };
         using slot_base = detail::slot_base<T...>;
         using slot_ptr = detail::slot_ptr<T...>;
-        using slots_type = std::vector<slot_ptr>;
+        using slots_type = detail::chunked_vector<detail::slot_entry<T...>>;  // slot table
         struct group_type { slots_type slts; group_id gid; };
         using list_type = std::vector<group_type>;  // kept ordered by ascending gid
+        using unique_index = detail::slot_index<detail::callable_key, detail::callable_key::hash, T...>;
+        using object_index = detail::slot_index<detail::obj_ptr, std::hash<detail::obj_ptr>, T...>;
+
+        // the indexes and the batch state, which most signals never need, so
+        // they are only allocated for signals with unique or object bound
+        // slots, or running a batch
+        struct extras {
+            unique_index unique;    // the unique slots
+            object_index objects;   // the slots bound to an object
+            list_type *batch = nullptr;  // the list a batch works on
+            std::atomic<std::thread::id> batch_owner{};  // the thread running a batch
+        };
 
     public:
         using arg_list = trait::typelist<T...>;
         using ext_arg_list = trait::typelist<connection&, T...>;
 
-        signal_base() noexcept : m_block(false) {}
+        signal_base() noexcept : m_block(false), m_parallel_blocking(false) {}
         ~signal_base() override {
             disconnect_all();
+            delete m_extras.load(std::memory_order_relaxed);
         }
 
         signal_base(const signal_base&) = delete;
@@ -1543,10 +3126,12 @@ namespace sigslot {
 
         signal_base(signal_base&& o) /* not noexcept */
         : m_block{o.m_block.load()}
+        , m_parallel_blocking{o.m_parallel_blocking.load()}
         {
             lock_type lock(o.m_mutex);
             using std::swap;
             swap(m_slots, o.m_slots);
+            m_extras.store(o.m_extras.exchange(nullptr), std::memory_order_release);
         }
 
         signal_base& operator=(signal_base&& o) /* not noexcept */ {
@@ -1556,7 +3141,9 @@ namespace sigslot {
 
             using std::swap;
             swap(m_slots, o.m_slots);
+            m_extras.store(o.m_extras.exchange(m_extras.load()), std::memory_order_release);
             m_block.store(o.m_block.exchange(m_block.load()));
+            m_parallel_blocking.store(o.m_parallel_blocking.exchange(m_parallel_blocking.load()));
             return *this;
         }
 
@@ -1568,23 +3155,48 @@ namespace sigslot {
          *         multiple threads simultaneously. The guarantees only apply to the
          *         signal object, it does not cover thread safety of potentially
          *         shared state used in slot functions.
+         * Moves: Rvalue arguments are moved rather than copied, into the queued
+         *        calls or into the last slot. A move-only argument can thus be
+         *        queued, read by any number of slots, and consumed by value by a
+         *        slot that is the only one of the signal.
          *          * @param a... arguments to emit
          */
         template <typename... U>
         void operator()(U&& ...a) const {
-            if (m_block) {
+            // a signal that never had any slot costs a single relaxed load
+            if (detail::cow_unset(m_slots) || m_block) {
                 return;
             }
 
-            // Reference to the slots to execute them out of the lock
-           // a copy may occur if another thread writes to it.
+            // Snapshot of the slots to execute them without locking, writers
+            // publish a new list instead of modifying this one.
             cow_copy_type<list_type, Lockable> ref = slots_reference();
 
-            for (const auto& group : detail::cow_read(ref)) {
-                for (const auto& s : group.slts) {
-                    s->operator()(a...);
+            const auto& groups = detail::cow_read(ref);
+
+            // the last slot is the last consumer of the arguments, it gets them
+            // forwarded and may move them, the others copy them
+            const detail::slot_entry<T...> *last = nullptr;
+            for (auto it = groups.rbegin(); it != groups.rend() && !last; ++it) {
+                if (!it->slts.empty()) {
+                    last = &it->slts.back();
                 }
             }
+
+            // queued calls are posted per destination queue when it goes away
+            auto source = std::forward_as_tuple(std::forward<U>(a)...);
+            detail::emission<T...> e(source, m_parallel_blocking.load(std::memory_order_relaxed));
+            for (const auto& group : groups) {
+                group.slts.for_each([&](const auto& s) {
+                    if (e.moved()) {
+                        std::apply([&](auto& ...m) { s(e, m...); }, e.args());
+                    } else if (&s == last) {
+                        s(e, std::forward<U>(a)...);
+                    } else {
+                        s(e, a...);
+                    }
+                });
+            }
         }
 
         /**
@@ -1601,19 +3213,16 @@ namespace sigslot {
         connect(Callable&& c, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot<Callable, T...>;
             auto s = make_slot<slot_t>(std::forward<Callable>(c), type, queue, gid);
-            auto o = get_slot([&](const auto& slot) {
-                return slot->has_callable(c);
-            });
-            if (o && o->is_unique()) {
-                connection conn;
-                conn.disconnect();
-                return conn;
-            }
             if (type & connection_type::unique_connection) {
                 s->set_unique(true);
             }
             connection conn(s);
-            add_slot(std::move(s));
+            const bool added = add_slot(std::move(s), {detail::get_function_ptr(c), nullptr}, nullptr, [&](const auto& slot) {
+                return slot->has_callable(c);
+            });
+            if (!added) {
+                return connection();
+            }
             return conn;
         }
 
@@ -1630,20 +3239,17 @@ namespace sigslot {
         connect_extended(Callable&& c, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot_extended<Callable, T...>;
             auto s = make_slot<slot_t>(std::forward<Callable>(c), type, queue, gid);
-            auto o = get_slot([&](const auto& slot) {
-                return slot->has_callable(c);
-            });
-            if (o && o->is_unique()) {
-                connection conn;
-                conn.disconnect();
-                return conn;
-            }
             if (type & connection_type::unique_connection) {
                 s->set_unique(true);
             }
             connection conn(s);
             std::static_pointer_cast<slot_t>(s)->conn = conn;
-            add_slot(std::move(s));
+            const bool added = add_slot(std::move(s), {detail::get_function_ptr(c), nullptr}, nullptr, [&](const auto& slot) {
+                return slot->has_callable(c);
+            });
+            if (!added) {
+                return connection();
+            }
             return conn;
         }
 
@@ -1661,20 +3267,18 @@ namespace sigslot {
         connect(Ptr&& ptr, Pmf&& pmf, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot_pmf<Ptr, Pmf, T...>;
             auto s = make_slot<slot_t>(std::forward<Ptr>(ptr), std::forward<Pmf>(pmf), type, queue, gid);
-            auto o = get_slot([&](const auto& slot) {
-                return slot->has_object(ptr) && slot->has_callable(pmf);
-            });
-            if (o && o->is_unique()) {
-                connection conn;
-                conn.disconnect();
-                return conn;
-            }
             if (type & connection_type::unique_connection) {
                 s->set_unique(true);
             }
             connection conn(s);
-            add_slot(std::move(s));
-            ptr->add_connection(conn);
+            s->observe(ptr->links(), s);
+            const auto obj = detail::get_object_ptr(ptr);
+            const bool added = add_slot(std::move(s), {detail::get_function_ptr(pmf), obj}, obj, [&](const auto& slot) {
+                return slot->has_object(ptr) && slot->has_callable(pmf);
+            });
+            if (!added) {
+                return connection();
+            }
             return conn;
         }
 
@@ -1692,19 +3296,17 @@ namespace sigslot {
         connect(Ptr&& ptr, Pmf&& pmf, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot_pmf<Ptr, Pmf, T...>;
             auto s = make_slot<slot_t>(std::forward<Ptr>(ptr), std::forward<Pmf>(pmf), type, queue, gid);
-            auto o = get_slot([&](const auto& slot) {
-                return slot->has_object(ptr) && slot->has_callable(pmf);
-            });
-            if (o && o->is_unique()) {
-                connection conn;
-                conn.disconnect();
-                return conn;
-            }
             if (type & connection_type::unique_connection) {
                 s->set_unique(true);
             }
             connection conn(s);
-            add_slot(std::move(s));
+            const auto obj = detail::get_object_ptr(ptr);
+            const bool added = add_slot(std::move(s), {detail::get_function_ptr(pmf), obj}, obj, [&](const auto& slot) {
+                return slot->has_object(ptr) && slot->has_callable(pmf);
+            });
+            if (!added) {
+                return connection();
+            }
             return conn;
         }
 
@@ -1721,20 +3323,18 @@ namespace sigslot {
         connect_extended(Ptr&& ptr, Pmf&& pmf, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot_pmf_extended<Ptr, Pmf, T...>;
             auto s = make_slot<slot_t>(std::forward<Ptr>(ptr), std::forward<Pmf>(pmf), type, queue, gid);
-            auto o = get_slot([&](const auto& slot) {
-                return slot->has_object(ptr) && slot->has_callable(pmf);
-            });
-            if (o && o->is_unique()) {
-                connection conn;
-                conn.disconnect();
-                return conn;
-            }
             if (type & connection_type::unique_connection) {
                 s->set_unique(true);
             }
             connection conn(s);
             std::static_pointer_cast<slot_t>(s)->conn = conn;
-            add_slot(std::move(s));
+            const auto obj = detail::get_object_ptr(ptr);
+            const bool added = add_slot(std::move(s), {detail::get_function_ptr(pmf), obj}, obj, [&](const auto& slot) {
+                return slot->has_object(ptr) && slot->has_callable(pmf);
+            });
+            if (!added) {
+                return connection();
+            }
             return conn;
         }
 
@@ -1757,21 +3357,20 @@ namespace sigslot {
         connect(Ptr&& ptr, Pmf&& pmf, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using trait::to_weak;
             auto w = to_weak(std::forward<Ptr>(ptr));
-            using slot_t = detail::slot_pmf_tracked<Pmf, decltype(w), T...>;
+            using slot_t = detail::slot_pmf_tracked<decltype(w), Pmf, T...>;
             auto s = make_slot<slot_t>(w, std::forward<Pmf>(pmf), type, queue, gid);
-            auto o = get_slot([&](const auto& slot) {
-                return slot->has_object(ptr) && slot->has_callable(pmf);
-            });
-            if (o && o->is_unique()) {
-                connection conn;
-                conn.disconnect();
-                return conn;
-            }
             if (type & connection_type::unique_connection) {
                 s->set_unique(true);
             }
             connection conn(s);
-            add_slot(std::move(s));
+            // ptr may have been moved into w
+            const auto obj = detail::get_object_ptr(w);
+            const bool added = add_slot(std::move(s), {detail::get_function_ptr(pmf), obj}, obj, [&](const auto& slot) {
+                return slot->has_object(w) && slot->has_callable(pmf);
+            });
+            if (!added) {
+                return connection();
+            }
             return conn;
         }
 
@@ -1794,21 +3393,18 @@ namespace sigslot {
         connect(Trackable&& ptr, Callable&& c, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using trait::to_weak;
             auto w = to_weak(std::forward<Trackable>(ptr));
-            using slot_t = detail::slot_tracked<Callable, decltype(w), T...>;
+            using slot_t = detail::slot_tracked<decltype(w), Callable, T...>;
             auto s = make_slot<slot_t>(w, std::forward<Callable>(c), type, queue, gid);
-            auto o = get_slot([&](const auto& slot) {
-                return slot->has_callable(c);
-            });
-            if (o && o->is_unique()) {
-                connection conn;
-                conn.disconnect();
-                return conn;
-            }
             if (type & connection_type::unique_connection) {
                 s->set_unique(true);
             }
             connection conn(s);
-            add_slot(std::move(s));
+            const bool added = add_slot(std::move(s), {detail::get_function_ptr(c), nullptr}, detail::get_object_ptr(w), [&](const auto& slot) {
+                return slot->has_callable(c);
+            });
+            if (!added) {
+                return connection();
+            }
             return conn;
         }
 
@@ -1857,7 +3453,7 @@ namespace sigslot {
                              !trait::is_callable_v<ext_arg_list, Obj> &&
                              !trait::is_pmf_v<Obj>, size_t>
         disconnect(const Obj& obj) {
-            return disconnect_if([&] (const auto& s) {
+            return disconnect_object(detail::get_object_ptr(obj), [&] (const auto& s) {
                 return s->has_object(obj);
             });
         }
@@ -1874,7 +3470,7 @@ namespace sigslot {
          */
         template <typename Obj, typename Callable>
         size_t disconnect(const Obj& obj, const Callable& c) {
-            return disconnect_if([&] (const auto& s) {
+            return disconnect_object(detail::get_object_ptr(obj), [&] (const auto& s) {
                 return s->has_object(obj) && s->has_callable(c);
             });
         }
@@ -1887,15 +3483,21 @@ namespace sigslot {
          * @return the number of disconnected slots
          */
         size_t disconnect(group_id gid) {
-            lock_type lock(m_mutex);
-            for (auto& group : detail::cow_write(m_slots)) {
-                if (group.gid == gid) {
-                    size_t count = group.slts.size();
-                    group.slts.clear();
-                    return count;
+            auto lock = lock_slots();
+            size_t count = 0;
+            write_slots([&](list_type& groups) {
+                for (auto& group : groups) {
+                    if (group.gid == gid) {
+                        count = group.slts.size();
+                        for (const auto& slot : group.slts) {
+                            unindex(slot.get());
+                        }
+                        group.slts.clear();
+                        return;
+                    }
                 }
-            }
-            return 0;
+            });
+            return count;
         }
 
         /**
@@ -1903,10 +3505,91 @@ namespace sigslot {
          * Safety: Thread safety depends on locking policy
          */
         void disconnect_all() {
-            lock_type lock(m_mutex);
+            auto lock = lock_slots();
             clear();
         }
 
+        /**
+         * The handle given to the function run by batch(), its functions work
+         * like those of the signal.
+         */
+        class transaction {
+        public:
+            template <typename... A>
+            connection connect(A&& ...a) {
+                return m_signal.connect(std::forward<A>(a)...);
+            }
+
+            template <typename... A>
+            connection connect_extended(A&& ...a) {
+                return m_signal.connect_extended(std::forward<A>(a)...);
+            }
+
+            template <typename... A>
+            size_t disconnect(A&& ...a) {
+                return m_signal.disconnect(std::forward<A>(a)...);
+            }
+
+            void disconnect_all() {
+                m_signal.disconnect_all();
+            }
+
+        private:
+            friend class signal_base;
+
+            explicit transaction(signal_base& s) noexcept
+            : m_signal(s)
+            {}
+
+            signal_base& m_signal;
+        };
+
+        /**
+         * Connects and disconnects slots at once
+         *          * Effect: Calls f with a transaction to connect and disconnect slots. The
+         *         changes are made to a single copy of the slot list, under a single
+         *         lock, and published when f returns, or throws. Emissions keep
+         *         calling the previous slots until then.
+         * Safety: Thread-safety depends on locking policy. Other threads modifying
+         *         the slots wait for the end of the batch, while the calling thread
+         *         may connect, disconnect and emit as usual from f.
+         *          * @param f a callable taking a transaction&
+         */
+        template <typename F>
+        void batch(F&& f) {
+            auto lock = lock_slots();
+            transaction tx(*this);
+            extras &x = get_extras();
+            if (x.batch) {
+                // nested in a batch of this thread
+                f(tx);
+                return;
+            }
+
+            struct scope {
+                scope(signal_base& s, extras& e)
+                : sig(s)
+                , x(e)
+                , list(s.read_slots())
+                {
+                    x.batch = &list;
+                    x.batch_owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+                }
+
+                ~scope() {
+                    x.batch_owner.store(std::thread::id(), std::memory_order_relaxed);
+                    x.batch = nullptr;
+                    detail::cow_assign(sig.m_slots, std::move(list));
+                }
+
+                signal_base& sig;
+                extras& x;
+                list_type list;
+            } guard(*this, x);
+
+            f(tx);
+        }
+
         /**
          * Blocks signal emission
          * Safety: thread safe
@@ -1930,6 +3613,24 @@ namespace sigslot {
             return m_block.load();
         }
 
+        /**
+         * Sets how emissions run blocking queued slots. By default each one is
+         * posted then waited for in turn, so an emission takes as long as all of
+         * them together. In parallel, they are all posted first and waited for
+         * at once, before the next slot that runs on the emitting thread or the
+         * end of the emission, so an emission takes as long as the slowest one.
+         * Slots of different task queues then run concurrently, reading the
+         * same arguments, none of them may consume those.
+         * Safety: thread safe
+         */
+        void set_parallel_blocking(bool parallel) noexcept {
+            m_parallel_blocking.store(parallel);
+        }
+
+        bool parallel_blocking() const noexcept {
+            return m_parallel_blocking.load();
+        }
+
         /**
          * Get number of connected slots
          * Safety: thread safe
@@ -1948,32 +3649,64 @@ namespace sigslot {
          * remove disconnected slots
          */
         void clean(detail::slot_state *state) override {
-            lock_type lock(m_mutex);
+            auto lock = lock_slots();
             const auto idx = state->index();
             const auto gid = state->group();
 
-            // find the group
-            for (auto &group : detail::cow_write(m_slots)) {
-                if (group.gid == gid) {
-                    auto &slts = group.slts;
+            // find the group and ensure we have the right slot, in case of
+            // concurrent cleaning, before publishing a new list
+            const auto& current = read_slots();
+            const bool found = std::any_of(current.begin(), current.end(), [&](const group_type& group) {
+                return group.gid == gid && idx < group.slts.size() && group.slts[idx].get() == state;
+            });
+            if (!found) {
+                return;
+            }
 
-                    // ensure we have the right slot, in case of concurrent cleaning
-                    if (idx < slts.size() && slts[idx] && slts[idx].get() == state) {
-                        std::swap(slts[idx], slts.back());
-                        slts[idx]->index() = idx;
-                        slts.pop_back();
+            write_slots([&](list_type& groups) {
+                for (auto &group : groups) {
+                    if (group.gid == gid) {
+                        auto &slts = group.slts;
+                        if (idx < slts.size() && slts[idx].get() == state) {
+                            unindex(state);
+                            slts.swap_remove(idx);
+                            if (idx < slts.size()) {
+                                slts[idx]->index() = idx;
+                            }
+                        }
+                        return;
                     }
+                }
+            });
+        }
 
-                    return;
+        void clean(detail::slot_state *const *states, std::size_t count) override {
+            auto lock = lock_slots();
+            write_slots([&](list_type& groups) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto *state = states[i];
+                    const auto idx = state->index();
+                    auto it = find_group(groups, state->group());
+                    if (it == groups.end() || it->gid != state->group()) {
+                        continue;
+                    }
+                    auto &slts = it->slts;
+                    // a slot already cleaned up is not there anymore
+                    if (idx < slts.size() && slts[idx].get() == state) {
+                        unindex(state);
+                        slts.swap_remove(idx);
+                        if (idx < slts.size()) {
+                            slts[idx]->index() = idx;
+                        }
+                    }
                 }
-            }
+            });
         }
 
     private:
         // used to get a reference to the slots for reading
         inline cow_copy_type<list_type, Lockable> slots_reference() const {
-            lock_type lock(m_mutex);
-            return m_slots;
+            return cow_copy_type<list_type, Lockable>(m_slots);
         }
 
         // create a new slot
@@ -1982,36 +3715,47 @@ namespace sigslot {
             return detail::make_shared<slot_base, Slot>(*this, std::forward<A>(a)...);
         }
 
-        // add the slot to the list of slots of the right group
-        void add_slot(slot_ptr&& s) {
+        // add the slot to the list of slots of the right group, unless a unique
+        // slot is connected already under key k, as confirmed by the predicate.
+        // obj is the object the slot is bound to, if any.
+        template <typename Same>
+        bool add_slot(slot_ptr&& s, const detail::callable_key& k, detail::obj_ptr obj, Same&& same) {
             const group_id gid = s->group();
 
-            lock_type lock(m_mutex);
-            auto &groups = detail::cow_write(m_slots);
-
-            // find the group
-            auto it = groups.begin();
-            while (it != groups.end() && it->gid < gid) {
-                it++;
+            auto lock = lock_slots();
+            extras *x = find_extras();
+            if (x && x->unique.contains(k, same)) {
+                return false;
             }
-
-            // create a new group if necessary
-            if (it == groups.end() || it->gid != gid) {
-                it = groups.insert(it, {{}, gid});
+            if (s->is_unique()) {
+                get_extras().unique.insert(k, s.get());
             }
+            if (obj) {
+                get_extras().objects.insert(obj, s.get());
+            }
+
+            write_slots([&](list_type& groups) {
+                auto it = find_group(groups, gid);
 
-            // add the slot
-            s->index() = it->slts.size();
-            it->slts.push_back(std::move(s));
+                // create a new group if necessary
+                if (it == groups.end() || it->gid != gid) {
+                    it = groups.insert(it, {{}, gid});
+                }
+
+                // add the slot
+                s->index() = it->slts.size();
+                it->slts.emplace_back(std::move(s));
+            });
+            return true;
         }
 
         template <typename Cond>
         bool has_slot(Cond&& cond) {
-            lock_type lock(m_mutex);
-            auto& groups = detail::cow_write(m_slots);
+            auto lock = lock_slots();
+            const auto& groups = read_slots();
 
-            for (auto& group : groups) {
-                auto& slts = group.slts;
+            for (const auto& group : groups) {
+                const auto& slts = group.slts;
                 size_t i = 0;
                 while (i < slts.size()) {
                     if (cond(slts[i])) {
@@ -2024,60 +3768,176 @@ namespace sigslot {
             return false;
         }
 
+        // disconnect a slot if a condition occurs
         template <typename Cond>
-        slot_ptr get_slot(Cond&& cond) {
-            lock_type lock(m_mutex);
-            auto& groups = detail::cow_write(m_slots);
+        size_t disconnect_if(Cond&& cond) {
+            auto lock = lock_slots();
 
-            for (auto& group : groups) {
-                auto& slts = group.slts;
-                size_t i = 0;
-                while (i < slts.size()) {
-                    if (cond(slts[i])) {
-                        return slts[i];
-                    } else {
-                        ++i;
+            // avoid publishing a copy of the list if nothing matches
+            const auto& current = read_slots();
+            const bool found = std::any_of(current.begin(), current.end(), [&](const group_type& group) {
+                return std::any_of(group.slts.begin(), group.slts.end(), cond);
+            });
+            if (!found) {
+                return 0;
+            }
+
+            size_t count = 0;
+
+            write_slots([&](list_type& groups) {
+                for (auto& group : groups) {
+                    auto& slts = group.slts;
+                    size_t i = 0;
+                    while (i < slts.size()) {
+                        if (cond(slts[i])) {
+                            unindex(slts[i].get());
+                            slts.swap_remove(i);
+                            if (i < slts.size()) {
+                                slts[i]->index() = i;
+                            }
+                            ++count;
+                        } else {
+                            ++i;
+                        }
                     }
                 }
-            }
-            return nullptr;
+            });
+
+            return count;
         }
 
-        // disconnect a slot if a condition occurs
+        // disconnect the slots bound to object obj for which a condition occurs,
+        // going through the slots of that object only
         template <typename Cond>
-        size_t disconnect_if(Cond&& cond) {
-            lock_type lock(m_mutex);
-            auto& groups = detail::cow_write(m_slots);
+        size_t disconnect_object(detail::obj_ptr obj, Cond&& cond) {
+            if (!obj) {
+                // slots bound to no object are not indexed
+                return disconnect_if(std::forward<Cond>(cond));
+            }
 
-            size_t count = 0;
+            auto lock = lock_slots();
+            const extras *x = find_extras();
+            if (!x) {
+                return 0;
+            }
 
-            for (auto& group : groups) {
-                auto& slts = group.slts;
-                size_t i = 0;
-                while (i < slts.size()) {
-                    if (cond(slts[i])) {
-                        std::swap(slts[i], slts.back());
-                        slts[i]->index() = i;
-                        slts.pop_back();
-                        ++count;
-                    } else {
-                        ++i;
+            std::vector<slot_base*> found;
+            x->objects.for_each(obj, [&](slot_base *s) {
+                if (cond(s)) {
+                    found.push_back(s);
+                }
+            });
+            if (found.empty()) {
+                return 0;
+            }
+
+            write_slots([&](list_type& groups) {
+                for (slot_base *s : found) {
+                    const group_id gid = s->group();
+                    auto it = find_group(groups, gid);
+                    assert(it != groups.end() && it->gid == gid);
+                    auto &slts = it->slts;
+                    const auto idx = s->index();
+                    assert(idx < slts.size() && slts[idx].get() == s);
+                    unindex(s);
+                    slts.swap_remove(idx);
+                    if (idx < slts.size()) {
+                        slts[idx]->index() = idx;
                     }
                 }
-            }
+            });
 
-            return count;
+            return found.size();
         }
 
         // to be called under lock: remove all the slots
         void clear() {
-            detail::cow_write(m_slots).clear();
+            for (const auto& group : read_slots()) {
+                group.slts.for_each([](const auto& s) {
+                    s->detach();
+                });
+            }
+            extras *x = find_extras();
+            if (x && x->batch) {
+                x->batch->clear();
+            } else {
+                detail::cow_reset(m_slots);
+            }
+            if (x) {
+                x->unique.clear();
+                x->objects.clear();
+            }
+        }
+
+        // the group of id gid, or the position to insert it at
+        static typename list_type::iterator find_group(list_type& groups, group_id gid) {
+            return std::lower_bound(groups.begin(), groups.end(), gid, [](const group_type& g, group_id id) {
+                return g.gid < id;
+            });
+        }
+
+        // lock the slots, unless the calling thread holds them for a batch.
+        // The slot lists writers unpublish are deleted once the lock has been
+        // released, so that slot destructors never run under it.
+        write_lock lock_slots() const {
+            const extras *x = m_extras.load(std::memory_order_acquire);
+            if (x && x->batch_owner.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+                return {{}, lock_type(m_mutex, std::defer_lock)};
+            }
+            return {{}, lock_type(m_mutex)};
+        }
+
+        // to be called under lock: the slot list, that of the ongoing batch if any
+        const list_type& read_slots() const {
+            const extras *x = find_extras();
+            return x && x->batch ? *x->batch : detail::cow_read(m_slots);
+        }
+
+        // to be called under lock: modify the slot list, in place during a batch
+        // and otherwise by publishing a modified copy
+        template <typename F>
+        void write_slots(F&& f) {
+            extras *x = find_extras();
+            if (x && x->batch) {
+                f(*x->batch);
+            } else {
+                detail::cow_write(m_slots, std::forward<F>(f));
+            }
+        }
+
+        // to be called under lock: drop a slot being removed from the indexes
+        // and detach it
+        void unindex(detail::slot_state *s) {
+            if (extras *x = find_extras()) {
+                x->unique.erase(s);
+                x->objects.erase(s);
+            }
+            s->detach();
+        }
+
+        // to be called under lock: the extras, nullptr until first needed
+        extras* find_extras() const {
+            return m_extras.load(std::memory_order_relaxed);
+        }
+
+        // to be called under lock: the extras, created on first use
+        extras& get_extras() {
+            extras *x = m_extras.load(std::memory_order_relaxed);
+            if (!x) {
+                x = new extras;
+                // published for lock_slots(), which reads the batch owner
+                // without the lock
+                m_extras.store(x, std::memory_order_release);
+            }
+            return *x;
         }
 
     private:
         mutable Lockable m_mutex;
         cow_type<list_type, Lockable> m_slots;
+        std::atomic<extras*> m_extras{nullptr};  // created on first use, guarded by m_mutex
         std::atomic<bool> m_block;
+        std::atomic<bool> m_parallel_blocking;
     };
 
     /**
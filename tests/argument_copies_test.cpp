@@ -0,0 +1,136 @@
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "check.h"
+#include "core/event.h"
+#include "core/task_queue.h"
+#include "signal.hpp"
+
+// Arguments are copied only when a slot needs its own copy: an rvalue is
+// moved into the last slot that takes it by value, a move-only argument
+// reaches a single slot, and an lvalue is never moved from.
+
+namespace {
+
+std::atomic<int> copies{0};
+std::atomic<int> moves{0};
+
+struct counted {
+    int value = 7;
+    bool moved_from = false;
+    bool from_move = false;
+
+    counted() = default;
+    counted(const counted& o) : value(o.value) { ++copies; }
+    counted(counted&& o) noexcept : value(o.value), from_move(true) {
+        ++moves;
+        o.value = 0;
+        o.moved_from = true;
+    }
+    counted& operator=(const counted& o) {
+        ++copies;
+        value = o.value;
+        return *this;
+    }
+    counted& operator=(counted&& o) noexcept {
+        ++moves;
+        value = o.value;
+        o.value = 0;
+        o.moved_from = true;
+        return *this;
+    }
+};
+
+void reset_counts() {
+    copies = 0;
+    moves = 0;
+}
+
+// waits for the tasks posted to `queue` so far to have run
+void drain(core::TaskQueue& queue) {
+    core::Event done;
+    queue.PostTask([&done] { done.Set(); });
+    done.Wait(core::Event::kForever);
+}
+
+void rvalue_to_direct_slots() {
+    constexpr int slots = 4;
+    sigslot::signal<counted> sig;
+    std::vector<int> values;
+    std::vector<bool> from_move;
+    for (int i = 0; i < slots; ++i) {
+        sig.connect([&](counted c) {
+            values.push_back(c.value);
+            from_move.push_back(c.from_move);
+        });
+    }
+
+    reset_counts();
+    sig(counted());
+    CHECK(copies <= slots - 1);
+    CHECK(values == std::vector<int>(slots, 7));
+    // the last slot gets the argument itself, not a copy
+    CHECK(from_move.size() == std::size_t(slots) && from_move.back());
+}
+
+void rvalue_to_queued_slot() {
+    auto queue = core::TaskQueue::Create("queue");
+    sigslot::signal<counted> sig;
+    std::atomic<int> value{0};
+    sig.connect([&value](counted c) { value = c.value; }, sigslot::queued_connection, queue.get());
+
+    reset_counts();
+    sig(counted());
+    drain(*queue);
+    CHECK(value == 7);
+    CHECK(copies == 0);
+}
+
+void move_only_to_single_slot() {
+    auto queue = core::TaskQueue::Create("queue");
+    {
+        sigslot::signal<std::unique_ptr<int>> sig;
+        int value = 0;
+        sig.connect([&value](std::unique_ptr<int> p) { value = *p; });
+        sig(std::make_unique<int>(3));
+        CHECK(value == 3);
+    }
+    {
+        sigslot::signal<std::unique_ptr<int>> sig;
+        std::atomic<int> value{0};
+        sig.connect([&value](std::unique_ptr<int> p) { value = *p; }, sigslot::queued_connection, queue.get());
+        sig(std::make_unique<int>(4));
+        drain(*queue);
+        CHECK(value == 4);
+    }
+}
+
+void lvalue_is_not_moved_from() {
+    auto queue = core::TaskQueue::Create("queue");
+    sigslot::signal<counted> sig;
+    std::atomic<int> sum{0};
+    sig.connect([&sum](counted c) { sum += c.value; });
+    sig.connect([&sum](counted c) { sum += c.value; }, sigslot::queued_connection, queue.get());
+    sig.connect([&sum](const counted& c) { sum += c.value; });
+    sig.connect([&sum](counted c) { sum += c.value; });
+
+    counted source;
+    reset_counts();
+    sig(source);
+    drain(*queue);
+    CHECK(sum == 4 * 7);
+    CHECK(!source.moved_from);
+    CHECK(source.value == 7);
+}
+
+} // namespace
+
+int main() {
+    rvalue_to_direct_slots();
+    rvalue_to_queued_slot();
+    move_only_to_single_slot();
+    lvalue_is_not_moved_from();
+    return check_failures();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdio>
+
+// Counts the failed checks of a test program, which returns them from main().
+inline int& check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++check_failures();                                                  \
+        }                                                                        \
+    } while (0)
@@ -0,0 +1,142 @@
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "check.h"
+#include "core/event.h"
+#include "core/queued_task.h"
+#include "core/task_queue.h"
+#include "signal.hpp"
+
+// Queued emissions must not allocate once warmed up, on the emitting thread
+// or on the workers: tasks and argument blocks are pooled.
+
+namespace {
+
+std::atomic<long> allocations{0};
+
+std::atomic<long> calls{0};
+
+struct receiver {
+    void on_value(int v, const std::string& s) { calls += v + static_cast<long>(s.size()) - 5; }
+};
+
+struct observing_receiver : sigslot::observer {
+    ~observing_receiver() override { disconnect_all(); }
+    void on_value(int v, const std::string& s) { calls += v + static_cast<long>(s.size()) - 5; }
+};
+
+// posted to a queue to wait for the tasks before it, without allocating:
+// the queue does not own it as run() returns false
+struct fence final : core::QueuedTask {
+    core::Event done;
+
+    bool run() override {
+        done.Set();
+        return false;
+    }
+};
+
+// waits for the tasks posted so far to have run and gone back to their pools
+void drain(core::TaskQueue& first, core::TaskQueue& second) {
+    fence a;
+    fence b;
+    first.PostTask(std::unique_ptr<core::QueuedTask>(&a));
+    second.PostTask(std::unique_ptr<core::QueuedTask>(&b));
+    a.done.Wait(core::Event::kForever);
+    b.done.Wait(core::Event::kForever);
+}
+
+// emits in bursts of 64, as a pool only holds as many tasks as were in
+// flight at once, waiting for each burst to be done
+void emit_bursts(sigslot::signal<int, const std::string&>& sig, core::TaskQueue& first,
+                 core::TaskQueue& second, int bursts) {
+    const std::string text("short");  // fits the small string buffer
+    for (int b = 0; b < bursts; ++b) {
+        for (int i = 0; i < 64; ++i) {
+            sig(1, text);
+        }
+        drain(first, second);
+    }
+}
+
+// emits a burst while both queues are held, so that every task of the burst
+// is in flight at once, as many as the pools will ever need
+void emit_held_burst(sigslot::signal<int, const std::string&>& sig, core::TaskQueue& first,
+                     core::TaskQueue& second) {
+    core::Event release(true, false);
+    first.PostTask([&release] { release.Wait(core::Event::kForever); });
+    second.PostTask([&release] { release.Wait(core::Event::kForever); });
+    const std::string text("short");
+    for (int i = 0; i < 64; ++i) {
+        sig(1, text);
+    }
+    release.Set();
+    drain(first, second);
+}
+
+} // namespace
+
+void* operator new(std::size_t n) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// The replaced operator new allocates with malloc, so free is the matching
+// release. GCC still flags it once these are inlined into callers, seeing
+// free on a pointer from operator new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+int main() {
+    auto first = core::TaskQueue::Create("first");
+    auto second = core::TaskQueue::Create("second");
+    {
+        sigslot::signal<int, const std::string&> sig;
+        receiver r;
+        observing_receiver o;
+        auto tracked = std::make_shared<receiver>();
+
+        sig.connect([](int v, const std::string& s) { calls += v + static_cast<long>(s.size()) - 5; },
+                    sigslot::queued_connection, first.get());
+        sig.connect(&r, &receiver::on_value, sigslot::queued_connection, first.get());
+        sig.connect(&o, &observing_receiver::on_value, sigslot::queued_connection, second.get());
+        sig.connect(tracked, &receiver::on_value, sigslot::queued_connection, second.get());
+        sig.connect(&r, &receiver::on_value, sigslot::queued_connection | sigslot::high_priority_connection, second.get());
+        sig.connect(&r, &receiver::on_value, sigslot::auto_connection, first.get());
+        const long slots = 6;
+
+        emit_held_burst(sig, *first, *second);
+        emit_bursts(sig, *first, *second, 50);
+
+        const long before = allocations;
+        emit_bursts(sig, *first, *second, 200);
+        const long after = allocations;
+        CHECK(after == before);
+        CHECK(calls == (1 + 250) * 64 * slots);
+        if (after != before) {
+            std::fprintf(stderr, "%ld allocations for %d queued emissions\n", after - before, 200 * 64);
+        }
+    }
+    return check_failures();
+}
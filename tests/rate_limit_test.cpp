@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "core/event.h"
+#include "core/task_queue.h"
+#include "core/time_utils.h"
+#include "signal.hpp"
+
+// Throttled and debounced slots keep their rate when they are slower than
+// the emissions: emissions made while the slot runs must not post calls of
+// their own.
+
+namespace {
+
+struct call_log {
+    std::mutex mutex;
+    std::vector<int64_t> started_us;
+    int last_value = 0;
+
+    void add(int v) {
+        std::lock_guard<std::mutex> lock(mutex);
+        started_us.push_back(core::TimeMicros());
+        last_value = v;
+    }
+};
+
+// waits for the tasks posted to `queue` so far to have run
+void drain(core::TaskQueue& queue) {
+    core::Event done;
+    queue.PostTask([&done] { done.Set(); });
+    done.Wait(core::Event::kForever);
+}
+
+// the last emission of emit_for()
+struct last_emission {
+    int value = 0;
+    int64_t at_us = 0;
+};
+
+// emits every millisecond for `duration`
+last_emission emit_for(sigslot::signal<int>& sig, std::chrono::milliseconds duration) {
+    const auto end = std::chrono::steady_clock::now() + duration;
+    last_emission last;
+    while (std::chrono::steady_clock::now() < end) {
+        sig(++last.value);
+        last.at_us = core::TimeMicros();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return last;
+}
+
+// connects a slot that takes 20 ms, on a queue of its own
+void connect_slow_slot(sigslot::signal<int>& sig, call_log& log, uint32_t type, core::TaskQueue& queue) {
+    sig.connect([&log](int v) {
+        log.add(v);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }, type, &queue);
+}
+
+void throttle_slower_slot() {
+    auto queue = core::TaskQueue::Create("throttled");
+    sigslot::signal<int> sig;
+    call_log log;
+    connect_slow_slot(sig, log, sigslot::throttle(100), *queue);
+
+    const int last = emit_for(sig, std::chrono::milliseconds(1000)).value;
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    drain(*queue);
+
+    std::lock_guard<std::mutex> lock(log.mutex);
+    // one call at once, then one per interval, and the trailing one
+    CHECK(log.started_us.size() >= 9 && log.started_us.size() <= 12);
+    for (std::size_t i = 1; i < log.started_us.size(); ++i) {
+        CHECK(log.started_us[i] - log.started_us[i - 1] >= 98000);
+    }
+    CHECK(log.last_value == last);
+}
+
+void debounce_slower_slot() {
+    auto queue = core::TaskQueue::Create("debounced");
+    sigslot::signal<int> sig;
+    call_log log;
+    connect_slow_slot(sig, log, sigslot::debounce(100), *queue);
+
+    // two bursts with a pause longer than the interval between them
+    const last_emission first = emit_for(sig, std::chrono::milliseconds(400));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const last_emission second = emit_for(sig, std::chrono::milliseconds(400));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    drain(*queue);
+
+    std::lock_guard<std::mutex> lock(log.mutex);
+    CHECK(log.started_us.size() == 2);
+    if (log.started_us.size() == 2) {
+        // an interval after the last emission of each burst
+        CHECK(log.started_us[0] >= first.at_us + 99000);
+        CHECK(log.started_us[1] >= second.at_us + 99000);
+    }
+    CHECK(log.last_value == second.value);
+}
+
+} // namespace
+
+int main() {
+    throttle_slower_slot();
+    debounce_slower_slot();
+    return check_failures();
+}
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "check.h"
+#include "signal.hpp"
+
+// Disconnected slots, and what their callables capture, must be destroyed
+// by the time the disconnection returns, or by the end of the emissions that
+// were running it, whatever happens to other signals.
+
+namespace {
+
+// runs a function when destroyed
+struct on_destroy {
+    std::function<void()> f;
+    ~on_destroy() { f(); }
+};
+
+void disconnect_releases_capture() {
+    sigslot::signal<int> sig;
+    auto token = std::make_shared<int>(0);
+    std::weak_ptr<int> w = token;
+    auto c = sig.connect([token](int) {});
+    token.reset();
+
+    CHECK(!w.expired());
+    c.disconnect();
+    CHECK(w.expired());
+    CHECK(!c.valid());
+}
+
+void every_disconnection_releases_capture() {
+    sigslot::signal<int> sig;
+    auto token = std::make_shared<int>(0);
+    std::weak_ptr<int> w = token;
+
+    sig.connect([token](int) {}, sigslot::direct_connection, nullptr, 1);
+    sig.disconnect(1);
+    {
+        sigslot::scoped_connection sc = sig.connect([token](int) {});
+    }
+    sig.connect([token](int) {});
+    sig.disconnect_all();
+    {
+        sigslot::signal<int> other;
+        other.connect([token](int) {});
+    }
+    token.reset();
+    CHECK(w.expired());
+}
+
+void disconnect_from_slot_releases_after_emission() {
+    sigslot::signal<int> sig;
+    auto token = std::make_shared<int>(0);
+    std::weak_ptr<int> w = token;
+    bool alive_during_call = false;
+    sig.connect_extended([token, &w, &alive_during_call](sigslot::connection& c, int) {
+        c.disconnect();
+        // the running emission keeps the slot alive
+        alive_during_call = !w.expired();
+    });
+    token.reset();
+
+    sig(1);
+    CHECK(alive_during_call);
+    CHECK(w.expired());
+}
+
+// a slot disconnected while another thread runs it is released by that
+// thread at the end of its emission, without any further write
+void concurrent_emission_releases_capture() {
+    sigslot::signal<int> sig;
+    auto token = std::make_shared<int>(0);
+    std::weak_ptr<int> w = token;
+    std::atomic<int> step{0};
+
+    auto c = sig.connect([token, &step](int) {
+        step = 1;
+        while (step != 2) {
+            std::this_thread::yield();
+        }
+    });
+    token.reset();
+
+    std::thread emitter([&] { sig(1); });
+    while (step != 1) {
+        std::this_thread::yield();
+    }
+    c.disconnect();
+    CHECK(!w.expired());
+    step = 2;
+    emitter.join();
+    CHECK(w.expired());
+}
+
+// slot destructors run on the disconnecting thread once the signal is
+// unlocked, so they may use the signal
+void destructor_may_use_signal() {
+    sigslot::signal<int> sig;
+    std::thread::id destroyed_on;
+    auto d = std::make_shared<on_destroy>();
+    d->f = [&] {
+        destroyed_on = std::this_thread::get_id();
+        sig.connect([](int) {});
+    };
+    auto c = sig.connect([d](int) {});
+    d.reset();
+
+    c.disconnect();
+    CHECK(destroyed_on == std::this_thread::get_id());
+    CHECK(sig.slot_count() == 1);
+}
+
+} // namespace
+
+int main() {
+    disconnect_releases_capture();
+    every_disconnection_releases_capture();
+    disconnect_from_slot_releases_after_emission();
+    concurrent_emission_releases_capture();
+    destructor_may_use_signal();
+    return check_failures();
+}
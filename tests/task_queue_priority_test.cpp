@@ -0,0 +1,93 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "check.h"
+#include "core/event.h"
+#include "core/queued_task.h"
+#include "core/task_queue.h"
+#include "core/time_utils.h"
+
+// A busy high priority lane slows the other tasks of a TaskQueueStdlib down
+// but never starves them, due delayed tasks included.
+
+namespace {
+
+// posts itself again with high priority until told to stop
+struct flood final : core::QueuedTask {
+    flood(core::TaskQueue& q, std::atomic<bool>& s) : queue(q), stop(s) {}
+
+    bool run() override {
+        if (stop) {
+            return true;
+        }
+        queue.PostTask(std::unique_ptr<core::QueuedTask>(this), core::TaskPriority::kHigh);
+        return false;
+    }
+
+    core::TaskQueue& queue;
+    std::atomic<bool>& stop;
+};
+
+// waits for the tasks posted to `queue` so far to have run
+void drain(core::TaskQueue& queue) {
+    core::Event done;
+    queue.PostTask([&done] { done.Set(); });
+    done.Wait(core::Event::kForever);
+}
+
+void delayed_task_under_high_flood() {
+    auto queue = core::TaskQueue::Create("flooded");
+    std::atomic<bool> stop{false};
+    for (int i = 0; i < 4; ++i) {
+        queue->PostTask(std::make_unique<flood>(*queue, stop), core::TaskPriority::kHigh);
+    }
+
+    core::Event ran;
+    const int64_t posted_us = core::TimeMicros();
+    std::atomic<int64_t> ran_us{0};
+    queue->PostDelayedTask(core::ToQueuedTask([&] {
+        ran_us = core::TimeMicros();
+        ran.Set();
+    }), core::TimeDelta::Millis(1));
+
+    // the flood goes on until the delayed task ran, or for a second
+    const bool in_time = ran.Wait(core::TimeDelta::Seconds(1));
+    stop = true;
+    drain(*queue);
+    CHECK(in_time);
+    CHECK(ran_us != 0 && ran_us - posted_us < 200000);
+}
+
+void normal_task_under_high_flood() {
+    auto queue = core::TaskQueue::Create("flooded");
+    std::atomic<bool> stop{false};
+    for (int i = 0; i < 4; ++i) {
+        queue->PostTask(std::make_unique<flood>(*queue, stop), core::TaskPriority::kHigh);
+    }
+
+    // set once both the normal and the low task ran
+    core::Event ran;
+    std::atomic<int> count{0};
+    const auto task = [&ran, &count] {
+        if (++count == 2) {
+            ran.Set();
+        }
+    };
+    queue->PostTask(task);
+    queue->PostTask(core::ToQueuedTask(task), core::TaskPriority::kLow);
+    const bool in_time = ran.Wait(core::TimeDelta::Seconds(1));
+    stop = true;
+    drain(*queue);
+    CHECK(in_time);
+}
+
+} // namespace
+
+int main() {
+    delayed_task_under_high_flood();
+    normal_task_under_high_flood();
+    return check_failures();
+}
@@ -0,0 +1,67 @@
+#include <memory>
+
+#include "check.h"
+#include "signal.hpp"
+
+// Slots bound to a tracked object are found by that object, whether the
+// shared_ptr was passed as an lvalue or as an rvalue moved into the slot.
+
+namespace {
+
+struct receiver : std::enable_shared_from_this<receiver> {
+    void on_value(int v) { n += v; }
+
+    sigslot::connection connect_self(sigslot::signal<int>& sig, uint32_t type) {
+        return sig.connect(shared_from_this(), &receiver::on_value, type);
+    }
+
+    int n = 0;
+};
+
+constexpr uint32_t kUnique = sigslot::unique_connection | sigslot::direct_connection;
+
+void disconnect_lvalue() {
+    sigslot::signal<int> sig;
+    auto r = std::make_shared<receiver>();
+    sig.connect(r, &receiver::on_value);
+
+    CHECK(sig.disconnect(r) == 1);
+    sig(1);
+    CHECK(r->n == 0);
+    CHECK(sig.slot_count() == 0);
+}
+
+void disconnect_rvalue() {
+    sigslot::signal<int> sig;
+    auto r = std::make_shared<receiver>();
+    r->connect_self(sig, sigslot::direct_connection);
+    sig.connect(std::shared_ptr<receiver>(r), &receiver::on_value);
+
+    CHECK(sig.disconnect(r) == 2);
+    sig(1);
+    CHECK(r->n == 0);
+    CHECK(sig.slot_count() == 0);
+}
+
+void unique_rvalue() {
+    sigslot::signal<int> sig;
+    auto r = std::make_shared<receiver>();
+    CHECK(r->connect_self(sig, kUnique).valid());
+    CHECK(!r->connect_self(sig, kUnique).valid());
+    CHECK(!sig.connect(std::shared_ptr<receiver>(r), &receiver::on_value, kUnique).valid());
+    CHECK(!sig.connect(r, &receiver::on_value, kUnique).valid());
+    CHECK(sig.slot_count() == 1);
+
+    auto other = std::make_shared<receiver>();
+    CHECK(other->connect_self(sig, kUnique).valid());
+    CHECK(sig.slot_count() == 2);
+}
+
+} // namespace
+
+int main() {
+    disconnect_lvalue();
+    disconnect_rvalue();
+    unique_rvalue();
+    return check_failures();
+}
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace thread_pool {
+
+    namespace detail {
+
+        /**
+         * Chase-Lev work-stealing deque of task pointers.
+         * The owning worker pushes and pops at the bottom, any other thread may
+         * steal from the top. The ring grows on demand; replaced rings are kept
+         * until the deque goes away since a thief may still be reading one.
+         * All index operations are sequentially consistent, which keeps the
+         * algorithm simple to reason about and visible to race detectors.
+         */
+        template <typename T>
+        class ws_deque {
+        public:
+            explicit ws_deque(std::size_t capacity = 256)
+            : m_ring(new ring(capacity))
+            {}
+
+            ws_deque(const ws_deque&) = delete;
+            ws_deque& operator=(const ws_deque&) = delete;
+
+            ~ws_deque() {
+                delete m_ring.load();
+            }
+
+            // owner only
+            void push(T *item) {
+                const int64_t b = m_bottom.load(std::memory_order_relaxed);
+                const int64_t t = m_top.load();
+                ring *r = m_ring.load(std::memory_order_relaxed);
+                if (b - t >= static_cast<int64_t>(r->capacity)) {
+                    r = grow(r, t, b);
+                }
+                r->put(b, item);
+                m_bottom.store(b + 1);
+            }
+
+            // owner only, returns nullptr if empty
+            T* pop() {
+                const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+                ring *r = m_ring.load(std::memory_order_relaxed);
+                m_bottom.store(b);
+                int64_t t = m_top.load();
+                if (t > b) {
+                    m_bottom.store(b + 1);
+                    return nullptr;
+                }
+                T *item = r->get(b);
+                if (t == b) {
+                    // last item, race against thieves for it
+                    if (!m_top.compare_exchange_strong(t, t + 1)) {
+                        item = nullptr;
+                    }
+                    m_bottom.store(b + 1);
+                }
+                return item;
+            }
+
+            // any thread, returns nullptr if empty or if another thread won
+            T* steal() {
+                int64_t t = m_top.load();
+                const int64_t b = m_bottom.load();
+                if (t >= b) {
+                    return nullptr;
+                }
+                T *item = m_ring.load()->get(t);
+                if (!m_top.compare_exchange_strong(t, t + 1)) {
+                    return nullptr;
+                }
+                return item;
+            }
+
+            bool empty() const {
+                return m_top.load() >= m_bottom.load();
+            }
+
+        private:
+            struct ring {
+                explicit ring(std::size_t cap)
+                : capacity(cap)
+                , mask(cap - 1)
+                , items(new std::atomic<T*>[cap])
+                {}
+
+                T* get(int64_t i) const {
+                    return items[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed);
+                }
+
+                void put(int64_t i, T *item) {
+                    items[static_cast<std::size_t>(i) & mask].store(item, std::memory_order_relaxed);
+                }
+
+                const std::size_t capacity;
+                const std::size_t mask;
+                std::unique_ptr<std::atomic<T*>[]> items;
+            };
+
+            ring* grow(ring *old, int64_t top, int64_t bottom) {
+                ring *r = new ring(old->capacity * 2);
+                for (int64_t i = top; i < bottom; ++i) {
+                    r->put(i, old->get(i));
+                }
+                m_retired.emplace_back(old);
+                m_ring.store(r);
+                return r;
+            }
+
+            std::atomic<int64_t> m_top {0};
+            std::atomic<int64_t> m_bottom {0};
+            std::atomic<ring*> m_ring;
+            std::vector<std::unique_ptr<ring>> m_retired;
+        };
+
+    } // namespace detail
+
+    /**
+     * A pool of worker threads scheduling tasks by work stealing.
+     *
+     * Each worker owns a deque: tasks submitted from a worker go to its own deque
+     * and are popped LIFO for cache locality, while idle workers steal FIFO from
+     * the deques of randomly picked victims. Tasks submitted from any other thread
+     * go through a shared injection queue. Workers finding nothing to do park on a
+     * condition variable, and submitters only touch it when a worker is parked.
+     *
+     * Tasks are handed over as raw pointers to a user supplied function, which
+     * decides what running and disposing of a task means. Tasks may run in any
+     * order and concurrently with each other; use a sequenced queue on top of the
+     * pool when ordering matters. Tasks still pending on destruction are given to
+     * the drop function instead.
+     */
+    template <typename Task>
+    class work_stealing_pool {
+    public:
+        using task_fn = std::function<void(Task*)>;
+
+        work_stealing_pool(std::size_t threads, task_fn run, task_fn drop)
+        : m_run(std::move(run))
+        , m_drop(std::move(drop))
+        {
+            threads = std::max<std::size_t>(threads, 1);
+            m_workers.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i) {
+                m_workers.emplace_back(new worker(*this, i));
+            }
+            for (auto &w : m_workers) {
+                w->thread = std::thread([this, p = w.get()] { loop(*p); });
+            }
+        }
+
+        work_stealing_pool(const work_stealing_pool&) = delete;
+        work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        // Must not be called from one of the workers.
+        ~work_stealing_pool() {
+            m_stop.store(true);
+            {
+                std::lock_guard<std::mutex> lock(m_park_mutex);
+                m_park_cv.notify_all();
+            }
+            for (auto &w : m_workers) {
+                w->thread.join();
+            }
+            for (auto &w : m_workers) {
+                while (Task *t = w->tasks.pop()) {
+                    m_drop(t);
+                }
+            }
+            for (Task *t : m_injected) {
+                m_drop(t);
+            }
+        }
+
+        void submit(Task *task) {
+            worker *self = current();
+            if (self && &self->pool == this) {
+                self->tasks.push(task);
+            } else {
+                inject(task);
+            }
+            notify();
+        }
+
+        // Submits through the shared injection queue even from a worker, so the
+        // task runs after those already waiting rather than next on this worker.
+        // Meant for long running tasks giving the worker up and re-submitting
+        // themselves to carry on later.
+        void submit_fair(Task *task) {
+            inject(task);
+            notify();
+        }
+
+        std::size_t size() const {
+            return m_workers.size();
+        }
+
+        // Returns true if the calling thread is one of the workers of this pool.
+        bool is_worker() const {
+            worker *self = current();
+            return self && &self->pool == this;
+        }
+
+    private:
+        struct worker {
+            worker(work_stealing_pool &p, std::size_t i)
+            : pool(p)
+            , index(i)
+            , rng(static_cast<uint32_t>(i * 2654435761u + 1))
+            {}
+
+            work_stealing_pool &pool;
+            const std::size_t index;
+            uint32_t rng;
+            detail::ws_deque<Task> tasks;
+            std::thread thread;
+        };
+
+        // number of injected tasks a worker moves to its own deque at once
+        static constexpr std::size_t inject_batch = 32;
+
+        static worker*& current() {
+            static thread_local worker *tls_worker = nullptr;
+            return tls_worker;
+        }
+
+        void loop(worker &self) {
+            current() = &self;
+            while (!m_stop.load()) {
+                if (Task *t = find_task(self)) {
+                    m_run(t);
+                    continue;
+                }
+                park();
+            }
+            current() = nullptr;
+        }
+
+        void inject(Task *task) {
+            std::lock_guard<std::mutex> lock(m_inject_mutex);
+            m_injected.push_back(task);
+            m_injected_size.store(m_injected.size());
+        }
+
+        Task* find_task(worker &self) {
+            if (Task *t = self.tasks.pop()) {
+                return t;
+            }
+            if (Task *t = take_injected(self)) {
+                return t;
+            }
+            return steal(self);
+        }
+
+        // Moves a batch of injected tasks to the deque of `self` and returns the
+        // oldest one.
+        Task* take_injected(worker &self) {
+            if (m_injected_size.load() == 0) {
+                return nullptr;
+            }
+            std::lock_guard<std::mutex> lock(m_inject_mutex);
+            if (m_injected.empty()) {
+                return nullptr;
+            }
+            Task *first = m_injected.front();
+            m_injected.pop_front();
+            const std::size_t n = std::min(inject_batch, m_injected.size());
+            // pushed newest first so that the owner pops them oldest first
+            for (std::size_t i = n; i > 0; --i) {
+                self.tasks.push(m_injected[i - 1]);
+            }
+            m_injected.erase(m_injected.begin(), m_injected.begin() + n);
+            m_injected_size.store(m_injected.size());
+            return first;
+        }
+
+        Task* steal(worker &self) {
+            const std::size_t n = m_workers.size();
+            if (n < 2) {
+                return nullptr;
+            }
+            // xorshift32, a random victim to start from then all the others
+            self.rng ^= self.rng << 13;
+            self.rng ^= self.rng >> 17;
+            self.rng ^= self.rng << 5;
+            const std::size_t start = self.rng % n;
+            for (std::size_t i = 0; i < n; ++i) {
+                worker &victim = *m_workers[(start + i) % n];
+                if (&victim == &self) {
+                    continue;
+                }
+                if (Task *t = victim.tasks.steal()) {
+                    return t;
+                }
+            }
+            return nullptr;
+        }
+
+        bool has_work() const {
+            if (m_injected_size.load() != 0) {
+                return true;
+            }
+            for (auto &w : m_workers) {
+                if (!w->tasks.empty()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void park() {
+            std::unique_lock<std::mutex> lock(m_park_mutex);
+            // announce first, then look again: a submitter either sees a sleeper
+            // and notifies, or published its task early enough for us to see it
+            m_sleepers.fetch_add(1);
+            if (!m_stop.load() && !has_work()) {
+                m_park_cv.wait(lock);
+            }
+            m_sleepers.fetch_sub(1);
+        }
+
+        void notify() {
+            if (m_sleepers.load() > 0) {
+                std::lock_guard<std::mutex> lock(m_park_mutex);
+                m_park_cv.notify_one();
+            }
+        }
+
+        task_fn m_run;
+        task_fn m_drop;
+        std::vector<std::unique_ptr<worker>> m_workers;
+
+        std::mutex m_inject_mutex;
+        std::deque<Task*> m_injected;
+        std::atomic<std::size_t> m_injected_size {0};
+
+        std::mutex m_park_mutex;
+        std::condition_variable m_park_cv;
+        std::atomic<int> m_sleepers {0};
+
+        std::atomic<bool> m_stop {false};
+    };
+
+} // namespace thread_pool